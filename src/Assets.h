@@ -0,0 +1,275 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "core/Archive.h"
+#include "Loader.h"
+#include "Profiler.h"
+
+// folders loose files are read from when there is no archive, relative to cmake-build-debug/bin
+inline const std::string ASSET_DIR = "../../src/imagesAudio/";
+inline const std::string FONT_DIR = "../../src/";
+
+// name of the packed archive the build writes next to the game
+inline const std::string ARCHIVE_NAME = "assets.pak";
+
+// rows of an image copied to its texture at a time by Assets::upload, a 1920 wide strip is about half a megabyte
+constexpr unsigned UPLOAD_ROWS = 64;
+// seconds of a frame a screen gives to uploading prefetched images
+constexpr float UPLOAD_BUDGET = 0.004f;
+
+// process-wide asset cache, every image, sound and font is read only once; assets are asked for by
+// file name and come out of the mapped archive when one is mounted, or from the loose files otherwise.
+// screens prefetch what they will need so it is decoded in the background and uploaded a strip at a
+// time, anything asked for before then is finished on the spot like it always was
+class Assets
+{
+private:
+    // an image being copied to its texture over several frames
+    struct Upload
+    {
+        std::string name;
+        sf::Image image;
+        sf::Texture texture;
+        unsigned row = 0;   // rows copied so far
+    };
+
+    AssetArchive archive;   // made first so the fonts reading straight from it are gone before it is
+    std::unordered_map<std::string, sf::Texture> textures;      // loaded images by name
+    std::unordered_map<std::string, sf::SoundBuffer> sounds;    // loaded sounds by name
+    std::unordered_map<std::string, sf::Font> fonts;            // opened fonts by name
+    std::optional<Upload> uploading;
+    AssetLoader loader;     // made last, so its worker has stopped before the archive it reads is unmapped
+
+    // the single cache shared by every screen
+    static Assets& instance()
+    {
+        static Assets assets;
+        return assets;
+    }
+
+    // where a file that is not packed lives
+    static std::string loosePath(const std::string& name)
+    {
+        return std::filesystem::exists(ASSET_DIR + name) ? ASSET_DIR + name : FONT_DIR + name;
+    }
+
+    // read a sound's samples, safe on the loader thread
+    static bool decodeSound(const std::string& name, sf::SoundBuffer& buffer)
+    {
+        const ArchiveEntry entry = packed(name);
+        return entry.data ? buffer.loadFromMemory(entry.data, entry.size) : buffer.loadFromFile(loosePath(name));
+    }
+
+    // start uploading a decoded asset, a sound joins the cache at once
+    static void startUpload(std::string name, DecodedAsset& asset)
+    {
+        Assets& assets = instance();
+        if (asset.sound && !assets.sounds.count(name))
+            assets.sounds.emplace(name, std::move(*asset.sound));
+        //an unreadable file is left for texture() to try again and report
+        if (!asset.image || asset.image->getSize().x == 0 || asset.image->getSize().y == 0 || assets.textures.count(name))
+            return;
+        sf::Texture texture(asset.image->getSize());
+        assets.uploading.emplace(Upload{std::move(name), std::move(*asset.image), std::move(texture), 0});
+    }
+
+    // copy the next strip of the image being uploaded, the texture joins the cache after its last strip
+    static void uploadStrip()
+    {
+        Assets& assets = instance();
+        Upload& upload = *assets.uploading;
+        const sf::Vector2u size = upload.image.getSize();
+        const unsigned rows = std::min(UPLOAD_ROWS, size.y - upload.row);
+        upload.texture.update(upload.image.getPixelsPtr() + static_cast<std::size_t>(upload.row) * size.x * 4, {size.x, rows}, {0, upload.row});
+        upload.row += rows;
+        if (upload.row < size.y)
+            return;
+        Profiler::count(Counter::TextureLoads);
+        assets.textures.emplace(std::move(upload.name), std::move(upload.texture));
+        assets.uploading.reset();
+    }
+
+public:
+    // map the archive, done once at startup before anything is loaded; false keeps the loose files
+    static bool mount(const std::string& path)
+    {
+        return instance().archive.open(path);
+    }
+
+    // the packed bytes of a file, nullptr data when there is no archive or it is not in it
+    static ArchiveEntry packed(const std::string& name)
+    {
+        return instance().archive.find(name);
+    }
+
+    // decode an image without keeping it, for the tile atlases
+    static sf::Image image(const std::string& name)
+    {
+        const ArchiveEntry entry = packed(name);
+        return entry.data ? sf::Image(entry.data, entry.size) : sf::Image(loosePath(name));
+    }
+
+    // get the texture for an image, loading it the first time it is asked for
+    static const sf::Texture& texture(const std::string& name)
+    {
+        return texture(name, [&name] { return image(name); });
+    }
+
+    // get the texture for an image made some other way (a tile atlas) under its own name, decode
+    // is only run when the image was not prefetched
+    static const sf::Texture& texture(const std::string& name, const std::function<sf::Image()>& decode)
+    {
+        Assets& assets = instance();
+        auto found = assets.textures.find(name);
+        if (found != assets.textures.end())
+            return found->second;   //map references stay valid when more textures are added
+        //half uploaded or still decoding in the background, finish that rather than start again
+        if (assets.uploading && assets.uploading->name == name)
+        {
+            while (assets.uploading)
+                uploadStrip();
+            return assets.textures.at(name);
+        }
+        Profiler::count(Counter::TextureLoads);
+        std::optional<DecodedAsset> decoded = assets.loader.take(name);
+        return assets.textures.emplace(name, sf::Texture(decoded && decoded->image ? *decoded->image : decode())).first->second;
+    }
+
+    // get the samples for a sound, loading them the first time they are asked for
+    static const sf::SoundBuffer& soundBuffer(const std::string& name)
+    {
+        Assets& assets = instance();
+        auto found = assets.sounds.find(name);
+        if (found == assets.sounds.end())
+        {
+            std::optional<DecodedAsset> decoded = assets.loader.take(name);
+            sf::SoundBuffer buffer;
+            if (decoded && decoded->sound)
+                buffer = std::move(*decoded->sound);
+            else if (!decodeSound(name, buffer))
+                buffer = sf::SoundBuffer();  //a missing file leaves an empty buffer that plays nothing
+            found = assets.sounds.emplace(name, std::move(buffer)).first;
+        }
+        return found->second;
+    }
+
+    // start decoding an image on the loader thread, its texture is made by upload or when it is first drawn
+    static void prefetch(const std::string& name)
+    {
+        prefetch(name, [name] { return image(name); });
+    }
+
+    // the same for an image made some other way, decode runs on the loader thread
+    static void prefetch(const std::string& name, std::function<sf::Image()> decode)
+    {
+        Assets& assets = instance();
+        if (assets.textures.count(name) || (assets.uploading && assets.uploading->name == name))
+            return;
+        assets.loader.request(name, [decode = std::move(decode)](DecodedAsset& asset) { asset.image = decode(); });
+    }
+
+    // start decoding a sound on the loader thread
+    static void prefetchSound(const std::string& name)
+    {
+        Assets& assets = instance();
+        if (assets.sounds.count(name))
+            return;
+        assets.loader.request(name, [name](DecodedAsset& asset)
+        {
+            sf::SoundBuffer buffer;
+            if (decodeSound(name, buffer))
+                asset.sound = std::move(buffer);
+        });
+    }
+
+    // turn decoded images into textures a strip of rows at a time, and decoded sounds into buffers,
+    // until budget has gone; true once everything prefetched is loaded
+    static bool upload(sf::Time budget)
+    {
+        Assets& assets = instance();
+        sf::Clock clock;
+        while (clock.getElapsedTime() < budget)
+        {
+            if (!assets.uploading)
+            {
+                std::optional<std::pair<std::string, DecodedAsset>> ready = assets.loader.takeReady();
+                if (!ready)
+                    break;
+                startUpload(std::move(ready->first), ready->second);
+                continue;
+            }
+            uploadStrip();
+        }
+        return loading() == 0;
+    }
+
+    // the same for only the assets named, which are decoded ahead of anything else waiting; an image
+    // already half uploaded is finished first. true once every one of them is loaded
+    static bool upload(sf::Time budget, const std::vector<std::string>& names)
+    {
+        Assets& assets = instance();
+        for (auto name = names.rbegin(); name != names.rend(); ++name)
+            assets.loader.hurry(*name);
+        sf::Clock clock;
+        while (clock.getElapsedTime() < budget)
+        {
+            if (!assets.uploading)
+            {
+                bool started = false;
+                for (const std::string& name : names)
+                {
+                    if (std::optional<DecodedAsset> ready = assets.loader.takeReady(name))
+                    {
+                        startUpload(name, *ready);
+                        started = true;
+                        break;
+                    }
+                }
+                if (!started)
+                    break;
+                continue;
+            }
+            uploadStrip();
+        }
+        return loading(names) == 0;
+    }
+
+    // prefetched assets not loaded yet
+    static std::size_t loading()
+    {
+        Assets& assets = instance();
+        return assets.loader.outstanding() + (assets.uploading ? 1 : 0);
+    }
+
+    // of the assets named, the ones still decoding or uploading
+    static std::size_t loading(const std::vector<std::string>& names)
+    {
+        Assets& assets = instance();
+        return static_cast<std::size_t>(std::count_if(names.begin(), names.end(), [&](const std::string& name)
+        {
+            return assets.loader.has(name) || (assets.uploading && assets.uploading->name == name);
+        }));
+    }
+
+    // get a font, opened the first time it is asked for; a packed font reads glyphs straight from
+    // the mapping, which stays open for as long as the font does
+    static const sf::Font& font(const std::string& name)
+    {
+        std::unordered_map<std::string, sf::Font>& fonts = instance().fonts;
+        auto found = fonts.find(name);
+        if (found == fonts.end())
+        {
+            const ArchiveEntry entry = packed(name);
+            found = fonts.emplace(name, entry.data ? sf::Font(entry.data, entry.size) : sf::Font(loosePath(name))).first;
+        }
+        return found->second;
+    }
+};
@@ -0,0 +1,107 @@
+#pragma once
+#include <SFML/Audio.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Assets.h"
+
+// every sound the game plays, decoded once by Audio::preload
+enum class SoundId : std::uint8_t
+{
+    Explosion,
+    Count
+};
+
+// ticket for one playback, it goes stale once its voice is given to another sound
+struct Voice
+{
+    std::uint16_t index = 0;
+    std::uint32_t generation = 0;
+};
+
+// fixed set of voices shared by the whole game, playing a sound points a free voice at a buffer
+// that is already in memory, or takes the voice that started longest ago when all are busy
+class Audio
+{
+private:
+    static constexpr std::size_t VOICES = 16;   // sounds that can play at the same time
+
+    // files of the sounds, in SoundId order
+    static constexpr const char* FILES[static_cast<std::size_t>(SoundId::Count)] = {"explosion.wav"};
+
+    std::array<const sf::SoundBuffer*, static_cast<std::size_t>(SoundId::Count)> buffers{};
+    std::vector<sf::Sound> voices;                  // made once, never moved
+    std::array<std::uint64_t, VOICES> startedAt{};  // play count when each voice last started
+    std::array<std::uint32_t, VOICES> generations{};
+    std::uint64_t plays = 0;
+
+    // the buffers come from the asset cache, which is made first and so outlives the voices using it
+    Audio()
+    {
+        for (std::size_t id = 0; id < buffers.size(); id++)
+            buffers[id] = &Assets::soundBuffer(FILES[id]);
+        voices.reserve(VOICES);
+        for (std::size_t voice = 0; voice < VOICES; voice++)
+            voices.emplace_back(*buffers[0]);
+    }
+
+    static Audio& instance()
+    {
+        static Audio audio;
+        return audio;
+    }
+
+public:
+    // start decoding every sound on the loader thread, so preload only has to pick them up
+    static void prefetch()
+    {
+        for (const char* file : FILES)
+            Assets::prefetchSound(file);
+    }
+
+    // decode every sound and make the voices, done once at startup so no click waits on the disk
+    static void preload()
+    {
+        instance();
+    }
+
+    // start a sound and hand back its voice
+    static Voice play(SoundId id, float volume = 100.f)
+    {
+        Audio& audio = instance();
+        const sf::SoundBuffer& buffer = *audio.buffers[static_cast<std::size_t>(id)];
+        //a free voice if there is one, otherwise the one that has played the longest
+        std::size_t chosen = 0;
+        for (std::size_t voice = 0; voice < VOICES; voice++)
+        {
+            if (audio.voices[voice].getStatus() == sf::SoundSource::Status::Stopped)
+            {
+                chosen = voice;
+                break;
+            }
+            if (audio.startedAt[voice] < audio.startedAt[chosen])
+                chosen = voice;
+        }
+        sf::Sound& sound = audio.voices[chosen];
+        sound.stop();
+        audio.startedAt[chosen] = ++audio.plays;
+        audio.generations[chosen]++;
+        Voice handle{static_cast<std::uint16_t>(chosen), audio.generations[chosen]};
+        //an empty buffer from a missing file plays nothing
+        if (buffer.getSampleCount() == 0)
+            return handle;
+        sound.setBuffer(buffer);
+        sound.setVolume(volume);
+        sound.play();
+        return handle;
+    }
+
+    // true while the sound started with this voice is still going
+    static bool playing(Voice voice)
+    {
+        Audio& audio = instance();
+        return voice.index < audio.voices.size() && audio.generations[voice.index] == voice.generation &&
+               audio.voices[voice.index].getStatus() != sf::SoundSource::Status::Stopped;
+    }
+};
@@ -0,0 +1,230 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Assets.h"
+#include "core/BitBoard.h"
+#include "Camera.h"
+#include "Profiler.h"
+
+// tiles in the order they are packed into a skin's atlas, the numbers line up with the mine count
+enum class Tile : std::uint8_t
+{
+    Empty, Num1, Num2, Num3, Num4, Num5, Num6, Num7, Num8,
+    Cover, Flag, Mine, MineWin,
+    Count
+};
+
+// pick the one tile a cell shows, which is the top layer of what the game used to draw
+inline Tile cellTile(bool mine, bool selected, bool flagged, int mineCount, int gameOver)
+{
+    if (mine && gameOver == 1)
+        return Tile::Mine;      //show every mine after a loss
+    if (mine && gameOver == 2)
+        return Tile::MineWin;   //show every mine after a win
+    if (!selected)
+        return flagged ? Tile::Flag : Tile::Cover;
+    if (mine)
+        return Tile::Mine;
+    return static_cast<Tile>(mineCount);    //zero is the empty selected square
+}
+
+// all tile images of one skin (Easy, Medium, Hard) packed side by side into one image, safe on the loader thread
+inline sf::Image packAtlas(const std::string& skin, unsigned tileSize)
+{
+    const std::string names[] = {
+        "emptySelectedSquare", "minNum1", "minNum2", "minNum3", "minNum4", "minNum5", "minNum6", "minNum7", "minNum8",
+        "emptySquare", "minFlag", "mine", "mineWin"
+    };
+    sf::Image atlas({tileSize * static_cast<unsigned>(Tile::Count), tileSize});
+    for (unsigned i = 0; i < static_cast<unsigned>(Tile::Count); i++)
+    {
+        sf::Image tile = Assets::image(names[i] + skin + ".png");  //decoded once while packing
+        //copy the tile into its slot
+        if (!atlas.copy(tile, {i * tileSize, 0}, sf::IntRect({0,0}, {static_cast<int>(tileSize), static_cast<int>(tileSize)})))
+            throw std::runtime_error(names[i] + skin + ".png is smaller than the tile size");
+    }
+    return atlas;
+}
+
+// name a skin's atlas is cached under next to the plain images
+inline std::string atlasName(const std::string& skin)
+{
+    return "atlas:" + skin;
+}
+
+// the texture of a skin's atlas, packed the first time unless it was prefetched
+inline const sf::Texture& tileAtlas(const std::string& skin, unsigned tileSize)
+{
+    return Assets::texture(atlasName(skin), [&] { return packAtlas(skin, tileSize); });
+}
+
+// start packing a skin's atlas in the background
+inline void prefetchAtlas(const std::string& skin, unsigned tileSize)
+{
+    Assets::prefetch(atlasName(skin), [skin, tileSize] { return packAtlas(skin, tileSize); });
+}
+
+// background and board kept in a render texture, only cells that changed are drawn again;
+// through a camera that has moved only the cells in view are turned into quads
+class BoardRenderer
+{
+private:
+    sf::VertexArray vertices;           // two triangles per cell, only kept when the board fits the screen
+    std::vector<Tile> tiles;            // the tile each cell currently shows
+    std::vector<std::size_t> dirty;     // cells whose tile changed since the last draw
+    std::vector<bool> isDirty;          // so a cell is only listed once
+    sf::VertexArray dirtyVertices;      // scratch quads for the dirty cells
+    sf::VertexArray visible;            // quads of the cells in the camera's view
+    const sf::Texture& atlas;           // tile images for this skin
+    sf::RenderTexture layer;            // cached background with the board on top
+    sf::Vector2f origin;                // top left of the board at its normal size
+    int width;                          // cells across
+    int height;                         // cells down
+    float cellSize;                     // pixels per cell
+    bool fits;                          // the whole board fits on the screen at its normal size
+    Cell visibleFirst{0, 0};            // cells the visible quads cover, last is exclusive
+    Cell visibleLast{0, 0};
+    int visibleMoves = -1;              // camera position the visible quads were made for
+    bool visibleStale = true;           // a cell in view changed its tile
+
+    // corners and atlas slot of one cell's two triangles
+    void writeQuad(sf::Vertex* quad, int rows, int columns, Tile tile) const
+    {
+        float left = origin.x + cellSize * rows;
+        float top = origin.y + cellSize * columns;
+        quad[0].position = {left, top};
+        quad[1].position = {left + cellSize, top};
+        quad[2].position = {left, top + cellSize};
+        quad[3].position = {left, top + cellSize};
+        quad[4].position = {left + cellSize, top};
+        quad[5].position = {left + cellSize, top + cellSize};
+        float slot = cellSize * static_cast<int>(tile);   //slot in the atlas
+        quad[0].texCoords = {slot, 0.f};
+        quad[1].texCoords = {slot + cellSize, 0.f};
+        quad[2].texCoords = {slot, cellSize};
+        quad[3].texCoords = {slot, cellSize};
+        quad[4].texCoords = {slot + cellSize, 0.f};
+        quad[5].texCoords = {slot + cellSize, cellSize};
+    }
+
+    // paint changed cells into the layer
+    void flushDirty()
+    {
+        if (dirty.empty())
+            return;
+        if (fits)
+        {
+            //gather the changed cells and paint them over their old tiles
+            dirtyVertices.resize(dirty.size() * 6);
+            for (std::size_t i = 0; i < dirty.size(); i++)
+            {
+                for (std::size_t corner = 0; corner < 6; corner++)
+                    dirtyVertices[i * 6 + corner] = vertices[dirty[i] * 6 + corner];
+            }
+            layer.draw(dirtyVertices, &atlas);
+            countDraw();
+            layer.display();
+        }
+        for (std::size_t cell : dirty)
+            isDirty[cell] = false;
+        dirty.clear();
+    }
+
+public:
+    BoardRenderer(const std::string& background, const std::string& skin, int widthIn, int heightIn, sf::Vector2f originIn, float cellSizeIn)
+        : tiles(static_cast<std::size_t>(widthIn) * heightIn, Tile::Count),
+          isDirty(tiles.size(), false),
+          dirtyVertices(sf::PrimitiveType::Triangles),
+          visible(sf::PrimitiveType::Triangles),
+          atlas(tileAtlas(skin, static_cast<unsigned>(cellSizeIn))),
+          layer({1920, 1080}),
+          origin(originIn), width(widthIn), height(heightIn), cellSize(cellSizeIn),
+          fits(originIn.x + widthIn * cellSizeIn <= 1920.f && originIn.y + heightIn * cellSizeIn <= 1080.f)
+    {
+        dirty.reserve(tiles.size());
+        if (fits)
+        {
+            vertices = sf::VertexArray(sf::PrimitiveType::Triangles, tiles.size() * 6);
+            //cell positions never change, so place the corners once
+            for (int rows = 0; rows < widthIn; rows++)
+            {
+                for (int columns = 0; columns < heightIn; columns++)
+                    writeQuad(&vertices[(static_cast<std::size_t>(columns) * width + rows) * 6], rows, columns, Tile::Cover);
+            }
+        }
+        //the background is drawn into the layer once, the cells follow on the first draw
+        layer.clear(sf::Color::Black);
+        layer.draw(sf::Sprite(Assets::texture(background), sf::IntRect({0,0},{1920,1080})));
+        //a board too big for the screen never paints cells into the layer, so finish it here
+        layer.display();
+    }
+
+    // show a tile in a cell, the quad is only rewritten and redrawn when the tile changes
+    void setTile(int rows, int columns, Tile tile)
+    {
+        std::size_t cell = static_cast<std::size_t>(columns) * width + rows;
+        if (tiles[cell] == tile)
+            return;
+        if (!isDirty[cell])
+        {
+            isDirty[cell] = true;
+            dirty.push_back(cell);
+        }
+        tiles[cell] = tile;
+        if (fits)
+            writeQuad(&vertices[cell * 6], rows, columns, tile);
+        if (rows >= visibleFirst.rows && rows < visibleLast.rows && columns >= visibleFirst.columns && columns < visibleLast.columns)
+            visibleStale = true;
+    }
+
+    // bring the layer up to date and show it, an unchanged board costs a single draw call
+    void draw(sf::RenderWindow& window)
+    {
+        flushDirty();
+        window.clear(sf::Color::Black);
+        window.draw(sf::Sprite(layer.getTexture()));
+        countDraw();
+    }
+
+    // show the board through a camera, at its normal place this is the cached layer,
+    // otherwise only the cells in view plus a margin of one are turned into quads
+    void draw(sf::RenderWindow& window, const Camera& camera)
+    {
+        if (fits && camera.atHome())
+        {
+            draw(window);
+            return;
+        }
+        flushDirty();
+        if (camera.moves() != visibleMoves || visibleStale)
+        {
+            camera.visibleCells(origin, cellSize, width, height, 1, visibleFirst, visibleLast);
+            visible.resize(static_cast<std::size_t>(visibleLast.rows - visibleFirst.rows) * (visibleLast.columns - visibleFirst.columns) * 6);
+            std::size_t quad = 0;
+            for (int columns = visibleFirst.columns; columns < visibleLast.columns; columns++)
+            {
+                for (int rows = visibleFirst.rows; rows < visibleLast.rows; rows++)
+                {
+                    writeQuad(&visible[quad * 6], rows, columns, tiles[static_cast<std::size_t>(columns) * width + rows]);
+                    quad++;
+                }
+            }
+            visibleMoves = camera.moves();
+            visibleStale = false;
+        }
+        window.clear(sf::Color::Black);
+        window.draw(sf::Sprite(layer.getTexture()));
+        //cover the board's frame, then draw the cells in view through the camera
+        sf::RectangleShape frame(camera.getFrame().size);
+        frame.setPosition(camera.getFrame().position);
+        frame.setFillColor(sf::Color(40, 40, 40));
+        window.draw(frame);
+        window.setView(camera.getView());
+        window.draw(visible, &atlas);
+        countDraw(3);
+        window.setView(window.getDefaultView());
+    }
+};
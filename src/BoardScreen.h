@@ -0,0 +1,551 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <iostream>
+#include <utility>
+#include <optional>
+#include <string>
+#include "Effects.h"
+#include "Hud.h"
+#include "BoardRenderer.h"
+#include "core/Board.h"
+#include "core/NoGuess.h"
+#include "core/Preset.h"
+#include "core/Replay.h"
+#include "core/Simulation.h"
+#include "core/Solver.h"
+#include "Camera.h"
+#include "HitTest.h"
+#include "Race.h"
+#include "Scene.h"
+
+// everything that makes one game screen different from another
+struct BoardConfig
+{
+    int rows;                   // squares across
+    int columns;                // squares down
+    int mines;                  // mines on the board
+    GameMode mode;              // classic or demolition rules
+    std::string background;     // screen image behind the board
+    std::string skin;           // tile set (Easy, Medium, Hard)
+    sf::Vector2i origin;        // top left corner of the board on screen
+    int cellSize;               // pixels per square
+    unsigned scoreSize;         // character size of the score
+    sf::Vector2f scorePosition; // where the score is written
+    sf::Vector2f livesLabelPosition; // where "Lives:" is written in demolition
+    sf::Vector2f livesPosition; // and the lives left
+    float ringDuration;         // how long a mine's ring wave grows for
+    void (*back)(SceneManager&); // screen the back button returns to
+    const BoardLayout* layout = nullptr; // a preset's pixel tables, nullptr works the squares out by dividing
+};
+
+// a config whose every number and image comes from a preset, only the back button is the screen's own
+template <class Preset>
+BoardConfig presetConfig(void (*back)(SceneManager&))
+{
+    const PresetScreen& screen = Preset::screen;
+    auto point = [](ScreenPoint at) { return sf::Vector2f(static_cast<float>(at.x), static_cast<float>(at.y)); };
+    return {Preset::rows, Preset::columns, Preset::mines, Preset::mode, screen.background, screen.skin,
+            {Preset::originX, Preset::originY}, Preset::cellSize, screen.scoreSize, point(screen.score),
+            point(screen.livesLabel), point(screen.lives), screen.ringDuration, back, &Preset::layout};
+}
+
+// folder every board played is saved to as a replay when the scene closes, empty when games are not kept
+inline std::string& replayFolder()
+{
+    static std::string folder;
+    return folder;
+}
+
+// one board being played, the back and reset buttons move on to the next scene
+class BoardScene : public Scene
+{
+private:
+    BoardConfig config;             // settings this board was made from
+    BoardSimulation sim;            // the game itself and the solver for the hint key, on the rules thread
+    std::vector<std::uint8_t> shownSquares; // squares of the snapshot the tiles were last picked from
+    int shownState = 0;
+    std::optional<Hint> hinted;     // square outlined after the hint key, until the next click
+    bool demolition;                // demolition rules and the lives display
+    float cellSize;                 // pixels per square
+    sf::Vector2f origin;            // top left of the board on screen
+    //score, and the lives left in demolition
+    Hud hud;
+    std::size_t scoreLine = 0;
+    std::size_t livesLine = 0;
+    //the board is shown in its frame at the normal size until the player zooms or scrolls
+    Camera camera;
+    //held middle button drags the board
+    std::optional<sf::Vector2i> dragFrom;
+    //batched board tiles for this skin
+    BoardRenderer boardTiles;
+    //every tile is picked again at the start, when the game ends and when a race corrects the board
+    bool boardChanged = true;
+    //effect manager
+    Effects effects;
+    bool didExplode = false;
+    //every move made, saved as a replay when the board is left
+    ReplayRecorder recorder;
+    sf::Clock playClock;
+    std::uint64_t tickOffset = 0;   // ticks already played by a replay this board continues
+    std::uint64_t seed = 0;         // mines as laid out by Board::generate, names the replay
+    //in a race, the connection to the server and the other player's board drawn small beside this one
+    std::unique_ptr<RaceLink> race;
+    std::vector<sf::Vertex> raceMap;
+    std::size_t rivalLine = 0;
+    std::size_t raceLine = 0;
+    static constexpr float RACE_MAP_SIZE = 300.f;
+    static inline const sf::Vector2f RACE_MAP_CORNER{100.f, 260.f};
+
+    // every move the board took goes into the replay
+    void record(const Cell& cell, ReplayAction action)
+    {
+        recorder.add({tickOffset + static_cast<std::uint64_t>(playClock.getElapsedTime().asMilliseconds()), cell.rows, cell.columns, action});
+    }
+
+    // hand a click to the rules thread; in a race it is the server's from now on too, in the same
+    // order the rules thread plays it, so the server's progress can be held up against the board
+    void sendMove(const Cell& cell, SimAction action, std::chrono::steady_clock::time_point inputTime)
+    {
+        if (!sim.send({action, cell, 0, inputTime}) || !race)
+            return;
+        race->race().play(cell.rows, cell.columns, action == SimAction::Flag ? ReplayAction::Flag : ReplayAction::Open);
+    }
+
+    // true once a race has ended, the board takes no more moves then
+    bool raceOver() const
+    {
+        return race && race->race().over();
+    }
+
+    // the other player's opened and flagged squares as one batch of quads
+    void buildRaceMap()
+    {
+        const RaceClient& client = race->race();
+        const RacePlayer& rival = client.view(client.player() == 0 ? 1 : 0);
+        const float scale = RACE_MAP_SIZE / static_cast<float>(std::max(config.rows, config.columns));
+        raceMap.clear();
+        auto quad = [&](sf::Vector2f corner, sf::Vector2f size, sf::Color color)
+        {
+            const sf::Vector2f a = corner, b = corner + sf::Vector2f(size.x, 0.f), c = corner + size, d = corner + sf::Vector2f(0.f, size.y);
+            for (sf::Vector2f point : {a, b, c, a, c, d})
+                raceMap.push_back(sf::Vertex{point, color});
+        };
+        quad(RACE_MAP_CORNER, {scale * config.rows, scale * config.columns}, sf::Color(90, 90, 90));
+        for (int rows = 0; rows < config.rows; rows++)
+        {
+            for (int columns = 0; columns < config.columns; columns++)
+            {
+                if (rival.opened.test(rows, columns) || rival.flagged.test(rows, columns))
+                    quad(RACE_MAP_CORNER + sf::Vector2f(scale * rows, scale * columns), {scale, scale},
+                         rival.flagged.test(rows, columns) ? sf::Color(220, 60, 40) : sf::Color(225, 225, 225));
+            }
+        }
+    }
+
+    // take in what the server sent: the rival's progress, the end of the race, and a corrected board;
+    // the network is read without the board, which is only borrowed for the compare
+    void updateRace()
+    {
+        const bool heard = race->update();
+        RaceClient& client = race->race();
+        //moves still on the rules thread or not shown yet would make the board look out of step,
+        //so the compare waits until the board holds exactly the moves the server was sent
+        if (client.needsCheck() && sim.settled())
+            reconcileRace();
+        if (!heard)
+            return;
+        hud.setNumber(rivalLine, client.view(client.player() == 0 ? 1 : 0).score);
+        if (client.over())
+            hud.setLabel(raceLine, client.raceWinner() < 0 ? "Race drawn" : client.raceWinner() == client.player() ? "Race won" : "Race lost");
+        buildRaceMap();
+    }
+
+    // put the board back to the server's when the two differ, and start the solver again from it
+    void reconcileRace()
+    {
+        RaceClient& client = race->race();
+        const bool rebuilt = sim.withBoard([&](Board& board, Solver& solver)
+        {
+            if (!client.reconcile(board))
+                return false;
+            std::vector<Cell> opened;
+            for (int rows = 0; rows < config.rows; rows++)
+            {
+                for (int columns = 0; columns < config.columns; columns++)
+                {
+                    if (board.isOpen(rows, columns))
+                        opened.push_back({rows, columns});
+                }
+            }
+            solver.reset();
+            solver.observe(board, opened);
+            return true;
+        });
+        if (rebuilt)
+        {
+            hinted.reset();
+            boardChanged = true;
+        }
+    }
+
+    // a board bigger than the screen keeps its frame inside the window
+    static Camera makeCamera(const BoardConfig& config)
+    {
+        const sf::Vector2f origin(config.origin);
+        const sf::Vector2f boardSize(static_cast<float>(config.cellSize * config.rows), static_cast<float>(config.cellSize * config.columns));
+        return Camera(sf::FloatRect(origin, {std::min(boardSize.x, 1920.f - origin.x), std::min(boardSize.y, 1080.f - origin.y)}),
+                      sf::FloatRect(origin, boardSize));
+    }
+
+    // bring one square's tile up to date from the snapshot being shown
+    void showCell(int r, int c)
+    {
+        const BoardSnapshot& view = sim.view();
+        const std::uint8_t square = view.squares[static_cast<std::size_t>(r) * config.columns + c];
+        const bool mine = square & BoardSnapshot::SQUARE_MINE;
+        boardTiles.setTile(r, c, cellTile(mine, square & BoardSnapshot::SQUARE_OPEN, square & BoardSnapshot::SQUARE_FLAG,
+                                          mine ? 0 : square >> BoardSnapshot::SQUARE_COUNT, view.state));
+    }
+
+    // pick up what the rules thread has done: tiles from its newest snapshot, then the sounds, effects
+    // and records of the moves that snapshot shows; this runs as the frame is drawn, so a click is
+    // shown by the first frame drawn after its rules are done
+    void takeSimulation(const sf::RenderWindow& window)
+    {
+        Profiler::addTime(Zone::Rules, sim.takeRulesTime());
+        if (sim.refresh())
+        {
+            const BoardSnapshot& view = sim.view();
+            //a game over can change every square, so pick every tile again, otherwise only the squares that changed
+            if (boardChanged || view.state != shownState)
+            {
+                for (int rows=0; rows<config.rows; rows++)
+                {
+                    for (int columns=0; columns<config.columns; columns++)
+                    {
+                        showCell(rows, columns);
+                    }
+                }
+                boardChanged=false;
+            }
+            else
+            {
+                for (std::size_t square = 0; square < view.squares.size(); square++)
+                {
+                    if (view.squares[square] != shownSquares[square])
+                        showCell(static_cast<int>(square / config.columns), static_cast<int>(square % config.columns));
+                }
+            }
+            shownSquares = view.squares;
+            shownState = view.state;
+            hud.setNumber(scoreLine, view.score);
+            if (demolition)
+                hud.setNumber(livesLine, view.lives);
+        }
+        SimEvent event;
+        while (sim.nextEvent(event))
+            showEvent(window, event);
+    }
+
+    // what one move did, once its squares are on screen
+    void showEvent(const sf::RenderWindow& window, const SimEvent& event)
+    {
+        Profiler::inputShown(event.command.inputTime);
+        const Cell& clicked = event.command.cell;
+        if (event.command.action == SimAction::Hint)
+        {
+            hinted = event.hint;
+            return;
+        }
+        if (!event.accepted)
+            return;
+        if (event.command.action == SimAction::Flag)
+        {
+            record(clicked, ReplayAction::Flag);
+            return;
+        }
+        record(clicked, ReplayAction::Open);
+        hinted.reset();
+        if (event.lostLife && sim.view().lives<=0 && !didExplode)
+        {
+            //explode in center
+            const sf::Vector2f center = window.getDefaultView().getCenter();
+            effects.spawn<ExplosionSoundEffect>();
+            effects.spawn<RingWaveEffect>(center, 0.f, 600.f, 0.1f, sf::Color(255,80,30));
+            effects.spawn<ParticleBurst>(center, 4000, sf::Color(120,70,40));
+            effects.spawn<ScreenFlashEffect>(sf::Color(255,255,255,220), 0.05f);
+            didExplode=true;
+        }
+        if (!event.hitMine)
+            return;
+        //location of mine on screen
+        const sf::Vector2f cellCenter = camera.toScreen({origin.x + cellSize*clicked.rows + cellSize/2.f,
+                                                         origin.y + cellSize*clicked.columns + cellSize/2.f}, window);
+        //a found demolition mine throws out debris, there can be many of these in a row
+        if (demolition)
+            effects.spawn<ParticleBurst>(cellCenter, 600, sf::Color(120,70,40));
+        //a classic mine explodes where it was found
+        else
+        {
+            //trigger effects
+            effects.spawn<ExplosionSoundEffect>();
+            effects.spawn<RingWaveEffect>(cellCenter, 0.f, 600.f, config.ringDuration, sf::Color(255,80,30));
+            effects.spawn<ParticleBurst>(cellCenter, 2000, sf::Color(120,70,40));
+            effects.spawn<ScreenFlashEffect>(sf::Color(255,255,255,220), 0.05f);
+        }
+    }
+
+public:
+    // a new board, or with a replay of this config's board the game as it stood after upTo of its moves,
+    // played on from there, or with a race link the race's board
+    explicit BoardScene(const BoardConfig& configIn, std::optional<ReplayReader> replay = std::nullopt, std::size_t upTo = SIZE_MAX,
+                        std::unique_ptr<RaceLink> link = nullptr)
+        : config(configIn),
+          sim(config.rows, config.columns, config.mines, config.mode),
+          shownSquares(static_cast<std::size_t>(config.rows) * config.columns, 0),
+          demolition(config.mode == GameMode::Demolition),
+          cellSize(static_cast<float>(config.cellSize)),
+          origin(config.origin),
+          camera(makeCamera(config)),
+          boardTiles(config.background, config.skin, config.rows, config.columns, origin, cellSize),
+          race(std::move(link))
+    {
+        //a replay or a race brings its own board, a no guess board was built and checked ahead of time,
+        //otherwise the mines come from a seed that is printed so the board can be played again
+        std::optional<NoGuessBoard> ready;
+        if (replay)
+            seed = replay->header().seed;
+        else if (race)
+            seed = race->race().header().seed;
+        else if (!demolition && BoardGenerator::shared().enabled())
+            seed = (ready = BoardGenerator::shared().take(config.rows, config.columns, config.mines))->seed;
+        else
+            seed = Seeds::next();
+        recorder.start({config.mode, config.rows, config.columns, config.mines, seed});
+        //set up before the rules thread starts, it plays every move after this
+        sim.withBoard([&](Board& board, Solver& solver)
+        {
+            board.generate(seed);
+            //the recorded moves are played through the rules at once, only the position they reach is drawn
+            if (replay)
+            {
+                std::size_t played = 0;
+                ReplayMove move;
+                while (played < upTo && replay->next(move))
+                {
+                    if (const ClickResult* opened = applyMove(board, move))
+                        solver.observe(board, opened->changed);
+                    recorder.add(move);
+                    played++;
+                }
+                tickOffset = replay->lastTick();
+                std::cout << "seed " << seed << " (replay after " << played << " moves)" << std::endl;
+            }
+            //the no guess board's first square is opened for the player
+            else if (ready)
+            {
+                std::cout << "seed " << seed << " (no guessing, starts at " << ready->start.rows << " " << ready->start.columns << ")" << std::endl;
+                solver.observe(board, board.open(ready->start.rows, ready->start.columns).changed);
+                record(ready->start, ReplayAction::Open);
+            }
+            else
+                std::cout << "seed " << seed << std::endl;
+        });
+        sim.start();
+        //the first snapshot fills these in before the first frame
+        scoreLine = hud.addNumber(0, config.scoreSize, config.scorePosition);
+        if (demolition)
+        {
+            hud.addLabel("Lives:", 55, config.livesLabelPosition);
+            livesLine = hud.addNumber(0, 50, config.livesPosition);
+        }
+        if (race)
+        {
+            hud.addLabel("Rival", 40, {RACE_MAP_CORNER.x, RACE_MAP_CORNER.y - 110.f});
+            rivalLine = hud.addNumber(0, 40, {RACE_MAP_CORNER.x, RACE_MAP_CORNER.y - 60.f});
+            raceLine = hud.addLabel("Racing", 40, {RACE_MAP_CORNER.x, RACE_MAP_CORNER.y + RACE_MAP_SIZE + 20.f});
+            std::cout << "racing as player " << race->race().player() + 1 << " of " << race->race().players() << std::endl;
+            buildRaceMap();
+        }
+    }
+
+    ~BoardScene() override
+    {
+        if (replayFolder().empty() || recorder.moves() == 0)
+            return;
+        const std::string path = replayFolder() + "/" + std::to_string(std::time(nullptr)) + "-" +
+                                 std::to_string(seed) + ".msr";
+        if (!recorder.save(path))
+            std::cerr << "cannot write " << path << std::endl;
+    }
+
+    void handle(const sf::Event& event, SceneManager& scenes) override
+    {
+        const sf::RenderWindow& window = scenes.getWindow();
+        //closes the game if the ESC key is pressed
+        if (const auto* keyPressed = event.getIf<sf :: Event :: KeyPressed>())
+        {
+            if (keyPressed->scancode == sf :: Keyboard :: Scancode :: Escape)
+                scenes.quit();
+            //the arrow keys scroll one square, home puts the board back to normal
+            else if (keyPressed->scancode == sf::Keyboard::Scancode::Left)
+                camera.pan({-cellSize, 0.f});
+            else if (keyPressed->scancode == sf::Keyboard::Scancode::Right)
+                camera.pan({cellSize, 0.f});
+            else if (keyPressed->scancode == sf::Keyboard::Scancode::Up)
+                camera.pan({0.f, -cellSize});
+            else if (keyPressed->scancode == sf::Keyboard::Scancode::Down)
+                camera.pan({0.f, cellSize});
+            else if (keyPressed->scancode == sf::Keyboard::Scancode::Home)
+                camera.reset();
+            //H outlines the square to open next: a safe one, or in demolition a mine
+            else if (keyPressed->scancode == sf::Keyboard::Scancode::H && sim.view().state == 0)
+                sim.send({SimAction::Hint, {0, 0}, Seeds::current(), std::chrono::steady_clock::now()});
+        }
+        //the mouse wheel zooms around the cursor
+        else if (const auto* mouseWheelScrolled = event.getIf<sf::Event::MouseWheelScrolled>())
+        {
+            camera.zoomAt(mouseWheelScrolled->delta > 0 ? 0.8f : 1.25f, mouseWheelScrolled->position, window);
+        }
+        else if (const auto* mouseButtonPressed = event.getIf<sf::Event::MouseButtonPressed>())
+        {
+            if (mouseButtonPressed->button == sf::Mouse::Button::Middle)
+                dragFrom = mouseButtonPressed->position;
+        }
+        else if (const auto* mouseMoved = event.getIf<sf::Event::MouseMoved>())
+        {
+            if (dragFrom)
+            {
+                camera.pan(sf::Vector2f(*dragFrom - mouseMoved->position));
+                dragFrom = mouseMoved->position;
+            }
+        }
+        else if (const auto* mouseButtonReleased = event.getIf<sf::Event::MouseButtonReleased>())
+        {
+            //where the click happened, taken from the event itself, and when, for the click to present time
+            const sf::Vector2i click = mouseButtonReleased->position;
+            const auto inputTime = std::chrono::steady_clock::now();
+            if (mouseButtonReleased->button == sf::Mouse::Button::Middle)
+                dragFrom.reset();
+            //find the square under the click with a table lookup (or one divide) per axis, after looking through the camera
+            std::optional<Cell> clicked;
+            if (std::optional<sf::Vector2i> point = camera.toBoard(click, window))
+                clicked = config.layout ? cellAt(*point, *config.layout) : cellAt(*point, config.origin, config.cellSize, config.rows, config.columns);
+            //checks if the user has right-clicked on the grid
+            if (mouseButtonReleased->button == sf::Mouse::Button::Right && !raceOver())
+            {
+                if (clicked)
+                    sendMove(*clicked, SimAction::Flag, inputTime);
+            }
+            //checks if the user has left-clicked on the grid or on one of the buttons
+            if (mouseButtonReleased->button == sf::Mouse::Button::Left)
+            {
+                //previous screen is shown again
+                if (BACK_BUTTON.contains(click))
+                    config.back(scenes);
+                //same board settings with new mines, a race has only the one board
+                else if (RESET_BUTTON.contains(click))
+                {
+                    if (!race)
+                        scenes.change<BoardScene>(config);
+                }
+                else if (clicked && !raceOver())
+                    sendMove(*clicked, SimAction::Open, inputTime);
+            }
+        }
+    }
+
+    void update(float secsSinceLastFrame) override
+    {
+        //update effects
+        {
+            ProfileScope timer(Zone::EffectsUpdate);
+            effects.update(secsSinceLastFrame);
+        }
+
+        if (race)
+            updateRace();
+    }
+
+    // a move still on the rules thread keeps frames coming until it is shown, and a race keeps
+    // drawing so the rival's progress shows as it comes in
+    bool animating() const override
+    {
+        return effects.size() > 0 || sim.waiting() || (race && race->online());
+    }
+
+    void draw(sf::RenderWindow& window) override
+    {
+        takeSimulation(window);
+        {
+            //cached background and board, one draw call when nothing changed and the camera is home
+            ProfileScope timer(Zone::Board);
+            boardTiles.draw(window, camera);
+            //green when the hint is certain, yellow for a guess
+            if (hinted)
+            {
+                sf::RectangleShape outline({cellSize - 4.f, cellSize - 4.f});
+                outline.setPosition({origin.x + cellSize*hinted->cell.rows + 2.f, origin.y + cellSize*hinted->cell.columns + 2.f});
+                outline.setFillColor(sf::Color::Transparent);
+                outline.setOutlineThickness(2.f);
+                outline.setOutlineColor(hinted->certain ? sf::Color(40,200,60) : sf::Color(240,200,30));
+                window.setView(camera.getView());
+                window.draw(outline);
+                countDraw();
+                window.setView(window.getDefaultView());
+            }
+        }
+        {
+            ProfileScope timer(Zone::Hud);
+            hud.draw(window);
+            if (!raceMap.empty())
+            {
+                window.draw(raceMap.data(), raceMap.size(), sf::PrimitiveType::Triangles);
+                countDraw();
+            }
+            //one cursor query per frame for the button highlights
+            sf::Vector2i mouse = sf::Mouse::getPosition(window);
+            if (BACK_BUTTON.contains(mouse))
+                drawTile(window, "backButtonHighlighted.png", 173, 77, 17.f, 14.f);
+            else
+                drawTile(window, "backButton.png", 173, 77, 17.f, 14.f);
+
+            if (RESET_BUTTON.contains(mouse))
+                drawTile(window, "resetButtonHighlighted.png", 173, 77, 1730.f, 14.f);
+            else
+                drawTile(window, "resetButton.png", 173, 77, 1730.f, 14.f);
+        }
+        ProfileScope timer(Zone::EffectsDraw);
+        effects.draw(window);
+    }
+};
+
+// every image a board's screen draws, by the names the asset cache keeps them under
+inline std::vector<std::string> boardAssets(const BoardConfig& config)
+{
+    return {config.background, atlasName(config.skin), "backButton.png", "backButtonHighlighted.png",
+            "resetButton.png", "resetButtonHighlighted.png"};
+}
+
+// start loading every image a board's screen draws, menus call this when the player looks like choosing it
+inline void prefetchBoard(const BoardConfig& config)
+{
+    //the atlas is packed from the skin's tiles rather than read from a file of its name
+    prefetchAtlas(config.skin, static_cast<unsigned>(config.cellSize));
+    for (const std::string& name : boardAssets(config))
+    {
+        if (name != atlasName(config.skin))
+            Assets::prefetch(name);
+    }
+}
+
+// start building no guess boards for a config while the player is still choosing one
+inline void prepareBoard(const BoardConfig& config)
+{
+    if (config.mode == GameMode::Classic && BoardGenerator::shared().enabled())
+        BoardGenerator::shared().prepare(config.rows, config.columns, config.mines);
+}
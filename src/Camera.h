@@ -0,0 +1,106 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include "core/BitBoard.h"
+
+// view of the board shown inside a fixed frame on screen, it can be panned and zoomed;
+// board coordinates are the pixels the board would cover at its normal size
+class Camera
+{
+private:
+    sf::View view;              // board area shown in the frame
+    sf::FloatRect frame;        // where on screen the board is shown
+    sf::FloatRect world;        // the whole board
+    float zoomLevel = 1.f;      // board pixels per screen pixel, bigger is further out
+    float maxZoom;              // far enough out to see the whole board
+    int version = 0;            // goes up every time the view moves
+
+    // keep the centre over the board so it cannot be scrolled away
+    void clampCenter()
+    {
+        sf::Vector2f center = view.getCenter();
+        center.x = std::clamp(center.x, world.position.x, world.position.x + world.size.x);
+        center.y = std::clamp(center.y, world.position.y, world.position.y + world.size.y);
+        view.setCenter(center);
+        version++;
+    }
+
+public:
+    Camera(sf::FloatRect frameIn, sf::FloatRect worldIn, sf::Vector2f screenSize = {1920.f, 1080.f})
+        : frame(frameIn), world(worldIn)
+    {
+        view.setViewport(sf::FloatRect({frame.position.x / screenSize.x, frame.position.y / screenSize.y},
+                                       {frame.size.x / screenSize.x, frame.size.y / screenSize.y}));
+        maxZoom = std::max({1.f, world.size.x / frame.size.x, world.size.y / frame.size.y});
+        reset();
+    }
+
+    // back to the normal size, showing the top left of the board in the frame
+    void reset()
+    {
+        zoomLevel = 1.f;
+        view.setSize(frame.size);
+        view.setCenter(frame.position + frame.size / 2.f);
+        clampCenter();
+    }
+
+    // move the view by a distance in screen pixels
+    void pan(sf::Vector2f screenDelta)
+    {
+        view.move(screenDelta * zoomLevel);
+        clampCenter();
+    }
+
+    // zoom in (factor below 1) or out around a screen pixel, the board under the pixel stays put
+    void zoomAt(float factor, sf::Vector2i pixel, const sf::RenderTarget& target)
+    {
+        float wanted = std::clamp(zoomLevel * factor, 0.25f, maxZoom);
+        if (wanted == zoomLevel)
+            return;
+        sf::Vector2f before = target.mapPixelToCoords(pixel, view);
+        view.setSize(frame.size * wanted);
+        zoomLevel = wanted;
+        sf::Vector2f after = target.mapPixelToCoords(pixel, view);
+        view.move(before - after);
+        clampCenter();
+    }
+
+    // true at the normal size and place, nothing has to be drawn differently from the plain layout
+    bool atHome() const
+    {
+        return zoomLevel == 1.f && view.getCenter() == frame.position + frame.size / 2.f;
+    }
+
+    // board position under a screen pixel, only if the pixel is inside the frame
+    std::optional<sf::Vector2i> toBoard(sf::Vector2i pixel, const sf::RenderTarget& target) const
+    {
+        if (!frame.contains(sf::Vector2f(pixel)))
+            return std::nullopt;
+        sf::Vector2f point = target.mapPixelToCoords(pixel, view);
+        return sf::Vector2i(static_cast<int>(std::floor(point.x)), static_cast<int>(std::floor(point.y)));
+    }
+
+    // screen pixel of a board position, for effects that are drawn without the view
+    sf::Vector2f toScreen(sf::Vector2f point, const sf::RenderTarget& target) const
+    {
+        return sf::Vector2f(target.mapCoordsToPixel(point, view));
+    }
+
+    // squares of a board whose cells are in view, plus margin squares on each side;
+    // first is inclusive and last is exclusive, both kept on the board
+    void visibleCells(sf::Vector2f origin, float cellSize, int rows, int columns, int margin, Cell& first, Cell& last) const
+    {
+        sf::Vector2f topLeft = view.getCenter() - view.getSize() / 2.f - origin;
+        sf::Vector2f bottomRight = view.getCenter() + view.getSize() / 2.f - origin;
+        first.rows = std::clamp(static_cast<int>(std::floor(topLeft.x / cellSize)) - margin, 0, rows);
+        first.columns = std::clamp(static_cast<int>(std::floor(topLeft.y / cellSize)) - margin, 0, columns);
+        last.rows = std::clamp(static_cast<int>(std::ceil(bottomRight.x / cellSize)) + margin, 0, rows);
+        last.columns = std::clamp(static_cast<int>(std::ceil(bottomRight.y / cellSize)) + margin, 0, columns);
+    }
+
+    const sf::View& getView() const { return view; }
+    const sf::FloatRect& getFrame() const { return frame; }
+    int moves() const { return version; }
+};
@@ -3,185 +3,133 @@
 //
 #ifndef DIFFICULTY_H
 #define DIFFICULTY_H
+#include <string>
 #include "Easy.h"
 #include "Medium.h"
 #include "Hard.h"
+#include "Endless.h"
 #include "Effects.h"
+#include "Hud.h"
+#include "HitTest.h"
+#include "Scene.h"
 
-void title();
+void title(SceneManager& scenes);
 
-inline void difficulty()
+// difficulty select with easy, medium and hard buttons and a back button
+class DifficultyScene : public Scene
 {
-    sf :: RenderWindow difficulty;
-    difficulty.create(sf :: VideoMode({1920,1080}), "MINESWEEPER", sf :: State :: Fullscreen);
-    difficulty.setFramerateLimit(60);
-    //initialize screen object
-    bool mouseHoverEasy,mouseHoverMedium,mouseHoverHard;
-    while (difficulty.isOpen())
+private:
+    //picture shown, it changes to highlight the button under the mouse
+    std::string screen = "Minesweeper_difficulty_select.png";
+    //N switches no guess boards on and off
+    Hud hud;
+    std::size_t noGuessLine = hud.addLabel("", 40, {760.f, 1000.f});
+
+    // show the option and have boards of every size built while the player chooses
+    void showNoGuess()
+    {
+        const bool on = BoardGenerator::shared().enabled();
+        hud.setLabel(noGuessLine, on ? "N: no guessing on" : "N: no guessing off");
+        prepareBoard(easyBoard());
+        prepareBoard(mediumBoard());
+        prepareBoard(hardBoard());
+    }
+
+public:
+    DifficultyScene()
+    {
+        showNoGuess();
+        for (const char* name : {"Minesweeper_difficulty_select_easy.png", "Minesweeper_difficulty_select_medium.png",
+                                 "Minesweeper_difficulty_select_hard.png"})
+            Assets::prefetch(name);
+    }
+
+    void handle(const sf::Event& event, SceneManager& scenes) override
     {
-        //checks for events that occur while the window is open
-        while (const std :: optional event = difficulty.pollEvent())
+        //closes the game if the user presses the ESC key
+        if (const auto* keyPressed = event.getIf<sf :: Event :: KeyPressed>())
         {
-            //if the user closes the window the program ends
-            if (event->is<sf :: Event :: Closed>())
-                difficulty.close();
-            //closes the window if the user presses the ESC key
-            else if (const auto* keyPressed = event->getIf<sf :: Event :: KeyPressed>())
-            {
-                if (keyPressed->scancode == sf :: Keyboard :: Scancode :: Escape)
-                    difficulty.close();
-            }
-            //sets up buttons for the user to click
-            else if (const auto* mouseButtonReleased = event->getIf<sf::Event::MouseButtonReleased>())
-            {
-                if (mouseButtonReleased->button == sf::Mouse::Button::Left)
-                {
-                    if (sf::Mouse::getPosition(difficulty).x >=17 && sf::Mouse::getPosition(difficulty).x <=189 && sf::Mouse::getPosition(difficulty).y >=14 && sf::Mouse::getPosition(difficulty).y <=89)
-                    {
-                        difficulty.close();
-                        //title window is reopened
-                        title();
-                    }
-                    else if ((sf::Mouse::getPosition(difficulty).x >=746 && sf::Mouse::getPosition(difficulty).x <=1170) && (sf::Mouse::getPosition(difficulty).y >= 189 && sf::Mouse::getPosition(difficulty).y <=319))
-                    {
-                        difficulty.close();
-                        //easy window opens
-                        Easy();
-                    }
-                    else if ((sf::Mouse::getPosition(difficulty).x >= 747 && sf::Mouse::getPosition(difficulty).x <= 1174) && (sf::Mouse::getPosition(difficulty).y >= 481 && sf::Mouse::getPosition(difficulty).y <= 605))
-                    {
-                        difficulty.close();
-                        //medium window opens
-                        Medium();
-                    }
-                    else if ((sf::Mouse::getPosition(difficulty).x >= 750 && sf::Mouse::getPosition(difficulty).x <= 1169) && (sf::Mouse::getPosition(difficulty).y >= 743 && sf::Mouse::getPosition(difficulty).y <= 873))
-                    {
-                        difficulty.close();
-                        //hard window opens
-                        Hard();
-                    }
-                }
-            }
-            //checks if mouse moved in order to highlight buttons
-            else if (const auto* mouseMoved = event->getIf<sf::Event::MouseMoved>())
+            if (keyPressed->scancode == sf :: Keyboard :: Scancode :: Escape)
+                scenes.quit();
+            //E opens the endless board, it has no button of its own
+            else if (keyPressed->scancode == sf::Keyboard::Scancode::E)
+                Endless(scenes);
+            else if (keyPressed->scancode == sf::Keyboard::Scancode::N)
             {
-                sf::Vector2i localPosition = sf::Mouse::getPosition(difficulty);
-                if ((localPosition.x >=746 && localPosition.x <=1170) && (localPosition.y >= 189 && localPosition.y <=319))
-                {
-                    loadScreen(difficulty, "../../src/imagesAudio/Minesweeper_difficulty_select_easy.png");
-                    if (sf::Mouse::getPosition(difficulty).x >=17 && sf::Mouse::getPosition(difficulty).x <=189 && sf::Mouse::getPosition(difficulty).y >=14 && sf::Mouse::getPosition(difficulty).y <=89)
-                    {
-                        drawTile(difficulty, "../../src/imagesAudio/backButtonHighlighted.png", 173, 77, 17.f, 14.f);
-                    }
-                    else
-                    {
-                        drawTile(difficulty, "../../src/imagesAudio/backButton.png", 173, 77, 17.f, 14.f);
-                    }
-                    difficulty.display();
-                    mouseHoverEasy=true;
-                }
-                else if ((localPosition.x >= 747 && localPosition.x <= 1174) && (localPosition.y >= 481 && localPosition.y <= 605))
-                {
-                    loadScreen(difficulty, "../../src/imagesAudio/Minesweeper_difficulty_select_medium.png");
-                    if (sf::Mouse::getPosition(difficulty).x >=17 && sf::Mouse::getPosition(difficulty).x <=189 && sf::Mouse::getPosition(difficulty).y >=14 && sf::Mouse::getPosition(difficulty).y <=89)
-                    {
-                        drawTile(difficulty, "../../src/imagesAudio/backButtonHighlighted.png", 173, 77, 17.f, 14.f);
-                    }
-                    else
-                    {
-                        drawTile(difficulty, "../../src/imagesAudio/backButton.png", 173, 77, 17.f, 14.f);
-                    }
-                    difficulty.display();
-                    mouseHoverMedium=true;
-                }
-                else if ((localPosition.x >= 750 && localPosition.x <= 1169) && (localPosition.y >= 743 && localPosition.y <= 873))
-                {
-                    loadScreen(difficulty, "../../src/imagesAudio/Minesweeper_difficulty_select_hard.png");
-                    if (sf::Mouse::getPosition(difficulty).x >=17 && sf::Mouse::getPosition(difficulty).x <=189 && sf::Mouse::getPosition(difficulty).y >=14 && sf::Mouse::getPosition(difficulty).y <=89)
-                    {
-                        drawTile(difficulty, "../../src/imagesAudio/backButtonHighlighted.png", 173, 77, 17.f, 14.f);
-                    }
-                    else
-                    {
-                        drawTile(difficulty, "../../src/imagesAudio/backButton.png", 173, 77, 17.f, 14.f);
-                    }
-                    difficulty.display();
-                    mouseHoverHard=true;
-                }
-                else
-                {
-                    loadScreen(difficulty, "../../src/imagesAudio/Minesweeper_difficulty_select.png");
-                    if (sf::Mouse::getPosition(difficulty).x >=17 && sf::Mouse::getPosition(difficulty).x <=189 && sf::Mouse::getPosition(difficulty).y >=14 && sf::Mouse::getPosition(difficulty).y <=89)
-                    {
-                        drawTile(difficulty, "../../src/imagesAudio/backButtonHighlighted.png", 173, 77, 17.f, 14.f);
-                    }
-                    else
-                    {
-                        drawTile(difficulty, "../../src/imagesAudio/backButton.png", 173, 77, 17.f, 14.f);
-                    }
-                    difficulty.display();
-                    mouseHoverEasy=false,mouseHoverMedium=false,mouseHoverHard=false;
-                }
+                BoardGenerator::shared().setEnabled(!BoardGenerator::shared().enabled());
+                showNoGuess();
             }
         }
-        //series of if statements to keep buttons highlighted again
-        if (mouseHoverEasy==true && mouseHoverMedium==false && mouseHoverHard==false)
+        //sets up buttons for the user to click
+        else if (const auto* mouseButtonReleased = event.getIf<sf::Event::MouseButtonReleased>())
         {
-            loadScreen(difficulty, "../../src/imagesAudio/Minesweeper_difficulty_select_easy.png");
-            if (sf::Mouse::getPosition(difficulty).x >=17 && sf::Mouse::getPosition(difficulty).x <=189 && sf::Mouse::getPosition(difficulty).y >=14 && sf::Mouse::getPosition(difficulty).y <=89)
+            //where the click happened, taken from the event itself
+            const sf::Vector2i click = mouseButtonReleased->position;
+            if (mouseButtonReleased->button == sf::Mouse::Button::Left)
             {
-                drawTile(difficulty, "../../src/imagesAudio/backButtonHighlighted.png", 173, 77, 17.f, 14.f);
+                //title screen is shown again
+                if (BACK_BUTTON.contains(click))
+                    title(scenes);
+                else if (EASY_BUTTON.contains(click))
+                    Easy(scenes);
+                else if (MEDIUM_BUTTON.contains(click))
+                    Medium(scenes);
+                else if (HARD_BUTTON.contains(click))
+                    Hard(scenes);
             }
-            else
-            {
-                drawTile(difficulty, "../../src/imagesAudio/backButton.png", 173, 77, 17.f, 14.f);
-            }
-            difficulty.display();
         }
-
-
-        else if (mouseHoverMedium==true && mouseHoverHard==false && mouseHoverEasy==false)
+        //checks if mouse moved in order to highlight buttons, they stay highlighted until the mouse moves off
+        else if (const auto* mouseMoved = event.getIf<sf::Event::MouseMoved>())
         {
-            loadScreen(difficulty, "../../src/imagesAudio/Minesweeper_difficulty_select_medium.png");
-            if (sf::Mouse::getPosition(difficulty).x >=17 && sf::Mouse::getPosition(difficulty).x <=189 && sf::Mouse::getPosition(difficulty).y >=14 && sf::Mouse::getPosition(difficulty).y <=89)
+            sf::Vector2i localPosition = mouseMoved->position;
+            //a board the mouse is over is likely next, so its images start loading now
+            if (EASY_BUTTON.contains(localPosition))
             {
-                drawTile(difficulty, "../../src/imagesAudio/backButtonHighlighted.png", 173, 77, 17.f, 14.f);
+                screen = "Minesweeper_difficulty_select_easy.png";
+                prefetchBoard(easyBoard());
             }
-            else
+            else if (MEDIUM_BUTTON.contains(localPosition))
             {
-                drawTile(difficulty, "../../src/imagesAudio/backButton.png", 173, 77, 17.f, 14.f);
+                screen = "Minesweeper_difficulty_select_medium.png";
+                prefetchBoard(mediumBoard());
             }
-            difficulty.display();
-        }
-
-        else if (mouseHoverHard==true && mouseHoverEasy==false && mouseHoverMedium==false)
-        {
-            loadScreen(difficulty, "../../src/imagesAudio/Minesweeper_difficulty_select_hard.png");
-            if (sf::Mouse::getPosition(difficulty).x >=17 && sf::Mouse::getPosition(difficulty).x <=189 && sf::Mouse::getPosition(difficulty).y >=14 && sf::Mouse::getPosition(difficulty).y <=89)
+            else if (HARD_BUTTON.contains(localPosition))
             {
-                drawTile(difficulty, "../../src/imagesAudio/backButtonHighlighted.png", 173, 77, 17.f, 14.f);
+                screen = "Minesweeper_difficulty_select_hard.png";
+                prefetchBoard(hardBoard());
             }
             else
-            {
-                drawTile(difficulty, "../../src/imagesAudio/backButton.png", 173, 77, 17.f, 14.f);
-            }
-            difficulty.display();
+                screen = "Minesweeper_difficulty_select.png";
         }
+    }
+
+    // prefetched images become textures a little each frame, so keep drawing until they are in
+    void update(float secsSinceLastFrame) override
+    {
+        (void)secsSinceLastFrame;
+        Assets::upload(sf::seconds(UPLOAD_BUDGET));
+    }
 
+    bool animating() const override
+    {
+        return Assets::loading() > 0;
+    }
+
+    void draw(sf::RenderWindow& window) override
+    {
+        loadScreen(window, screen);
+        hud.draw(window);
+        //one cursor query per frame for the back button highlight
+        if (BACK_BUTTON.contains(sf::Mouse::getPosition(window)))
+            drawTile(window, "backButtonHighlighted.png", 173, 77, 17.f, 14.f);
         else
-        {
-            loadScreen(difficulty, "../../src/imagesAudio/Minesweeper_difficulty_select.png");
-            if (sf::Mouse::getPosition(difficulty).x >=17 && sf::Mouse::getPosition(difficulty).x <=189 && sf::Mouse::getPosition(difficulty).y >=14 && sf::Mouse::getPosition(difficulty).y <=89)
-            {
-                drawTile(difficulty, "../../src/imagesAudio/backButtonHighlighted.png", 173, 77, 17.f, 14.f);
-            }
-            else
-            {
-                drawTile(difficulty, "../../src/imagesAudio/backButton.png", 173, 77, 17.f, 14.f);
-            }
-            difficulty.display();
-        }
+            drawTile(window, "backButton.png", 173, 77, 17.f, 14.f);
     }
+};
+
+inline void difficulty(SceneManager& scenes)
+{
+    scenes.change<DifficultyScene>();
 }
 
-#endif //DIFFICULTY_H
\ No newline at end of file
+#endif //DIFFICULTY_H
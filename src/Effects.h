@@ -1,233 +1,82 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <utility>
 #include <vector>
+#include "Assets.h"
+#include "Audio.h"
+#include "Profiler.h"
+#include "core/Mines.h"
 
 // draw large image into screen
-static void loadScreen(sf::RenderWindow &screen, std::string path)
+static void loadScreen(sf::RenderWindow &screen, const std::string& path)
 {
     screen.clear(sf::Color::Black); //clear image with black
-    sf::Texture texture(path, false, sf::IntRect({0,0},{1920,1080}));   //load images with size
-    sf::Sprite sprite(texture); //create sprite
+    sf::Sprite sprite(Assets::texture(path), sf::IntRect({0,0},{1920,1080}));   //cached image with size
     screen.draw(sprite);    //display sprite
+    countDraw();
 }
 
 // draw a tile at specific location
-static void drawTile(sf::RenderWindow &screen, std::string path, int w, int h, float x, float y)
+static void drawTile(sf::RenderWindow &screen, const std::string& path, int w, int h, float x, float y)
 {
-    sf::Texture texture(path, false, sf::IntRect({0,0}, {w,h}));    //load small image
-    sf::Sprite sprite(texture); //create sprite
+    sf::Sprite sprite(Assets::texture(path), sf::IntRect({0,0}, {w,h}));    //cached small image
     sprite.setPosition({x,y});  //move image to location
     screen.draw(sprite);    //display sprite
+    countDraw();
 }
 
-//works for any grid size
-template <std::size_t H, std::size_t W>
-// Count mines near a square
-int countMines(const bool (&grid)[H][W], int rows, int columns) //grid where mine is, and where it is
-{
-    int checkHorizontal;
-    int checkVertical;
-    int count = 0;
-    //peek at the eight neighbors
-    for (int horizontal = -1; horizontal <= 1; horizontal++)    //looks at horizontal neigbors
-    {
-        for (int vertical = -1; vertical <= 1; vertical++)  //looks at vertical neighbors
-        {
-            if (horizontal == 0 && vertical == 0)   //skip where you are
-                continue;
-            else
-            {   //get neighbor coordinates
-                checkHorizontal = rows + horizontal;
-                checkVertical = columns + vertical;
-            }
-            // makes sure the array stays in bounds
-            if ((checkHorizontal >= 0 && checkHorizontal < static_cast<int>(H)) &&  (checkVertical   >= 0 && checkVertical  < static_cast<int>(W)))
-            {
-                // if neighbor square is on board and has mine, add 1
-                if (grid[checkHorizontal][checkVertical])
-                    count++;
-            }
-        }
-    }
-    return count;
-}
-
-//works for any grid size
-template <std::size_t H, std::size_t W>
-// flood reveal and scoring
-int floodScore(const bool (&grid)[H][W], bool (&selected)[H][W], bool (&scored)[H][W], int rows, int columns)
-{
-    int score = 0;
-    int checkHorizontal;
-    int checkVertical;
-    //look at the 8 neighbors
-    for (int horizontal = -1; horizontal <= 1; horizontal++)
-    {
-        for (int vertical = -1; vertical <= 1; vertical++)
-        {   //skip where you are
-            if (horizontal == 0 && vertical == 0)
-            {
-                continue;
-            }
-            else
-            {   //get neighbor coordinates
-                checkHorizontal = rows + horizontal;
-                checkVertical = columns + vertical;
-            }
-            // makes sure the array stays in bounds
-            if ((checkHorizontal >= 0 && checkHorizontal < static_cast<int>(H)) && (checkVertical   >= 0 && checkVertical   < static_cast<int>(W)))
-            {
-                // if the square is not a mine and has not already been scored, then that square is selected and then scored
-                if (!grid[checkHorizontal][checkVertical] && !scored[checkHorizontal][checkVertical])
-                {
-                    selected[checkHorizontal][checkVertical] = true;
-                    scored[checkHorizontal][checkVertical] = true;
-                    score += 100;
-                }
-            }
-        }
-    }
-    return score;
-}
-
-    //use any grid size
-template <std::size_t H, std::size_t W>
-// flood for demolition
-void floodDemolition(const bool (&grid)[H][W], bool (&selected)[H][W], int rows, int columns)
-{
-    int checkHorizontal;
-    int checkVertical;
-    //look at the 8 neighbors
-    for (int horizontal = -1; horizontal <= 1; horizontal++)
-    {
-        for (int vertical = -1; vertical <= 1; vertical++)
-        {   //skip your picked mine
-            if (horizontal == 0 && vertical == 0)
-            {
-                continue;
-            }
-            else
-            {   //get neighbor coordinates
-                checkHorizontal = rows + horizontal;
-                checkVertical = columns + vertical;
-            }
-            // makes sure the array stays in bounds
-            if ((checkHorizontal >= 0 && checkHorizontal < static_cast<int>(H)) && (checkVertical   >= 0 && checkVertical   < static_cast<int>(W)))
-            {
-                // if the square is not a mine then select it
-                if (!grid[checkHorizontal][checkVertical])
-                {
-                    selected[checkHorizontal][checkVertical] = true;
-                }
-            }
-        }
-    }
-}
-
-// abstract class for visual effects
-class Effect {
-public:
-    virtual bool update(float) = 0; // move the effect forward one step, return true when done
-    virtual void draw(sf::RenderWindow& window) const = 0; // draw the effect
-    virtual ~Effect() = default; // delete effect through base pointer
-};
-    //effects manager
-class Effects {
-    private:
-    std::vector<Effect*> effectsList; // stores pointers to effects
-
-    public:
-    // create new effect of type T, with any arguments passed
-    template <class T, class... Args>
-    T& spawn(Args... args)  // create new effect with given arguments
-    {
-        T* created = new T(args...);  // allocate effect
-        effectsList.push_back(created);  // store base-class pointer to update and draw for later
-        return *created; // return reference to new effect
-    }
-
-    // add new effect to list
-    void spawn(Effect* effectPtr)
-    {
-        effectsList.push_back(effectPtr);  // store it ti update and draw later
-    }
-
-    // advance and remove finished
-    void update(float frameTimeSec)
-    {
-        int i = 0;
-        //loop through effects
-        while (i < (int)effectsList.size())
-        { // loop over list of effects to do
-            bool done = effectsList[i]->update(frameTimeSec);
-            if (done)
-            {
-                delete effectsList[i]; // free memory
-                effectsList.erase(effectsList.begin() + i); // remove from list
-            }
-            else
-            {
-                ++i; // move to next effect
-            }
-        }
-    }
-
-    // draw all active effects
-    void draw(sf::RenderWindow& window) const
-    {   //go through each effect and draw them
-        for (int i = 0; i < (int)effectsList.size(); ++i)
-            effectsList[i]->draw(window);
-    }
-        //clean up all effects
-    ~Effects()
-    {
-        //loop through effects and delete
-        for (int i = 0; i < (int)effectsList.size(); ++i)
-            delete effectsList[i];
-        effectsList.clear();
-    }
-};
-
-// circle that expands from a center point
-class RingWaveEffect : public Effect
+// expanding circle from a center point, only its numbers are kept,
+// every ring is drawn with the one circle shape its pool shares
+class RingWaveEffect
 {
     private:
+    sf::Vector2f center;    //fixed center position
     float startRadius;  //start size
     float endRadius;    //end size
+    sf::Color outlineColor;
 
     float lifetime;   // total duration in seconds
     float elapsed{0}; // time lived so far in seconds
-
-    sf::CircleShape ringShape;  //sfml circle
+    float radius;     // size this frame
 
     public:
-    RingWaveEffect(sf::Vector2f center, float startRadiusIn, float endRadiusIn,
-                   float lifetimeSecondsIn, sf::Color outlineColor)
+    // a demolition chain reaction can have a few hundred rings going at once
+    static constexpr std::size_t CAPACITY = 512;
+    static constexpr std::size_t DRAWS = 1;     // draw calls per effect
+
+    // circle drawn for each ring in turn
+    struct Shared
     {
-        // set radii
-        startRadius = startRadiusIn;
-        endRadius   = endRadiusIn;
+        sf::CircleShape ring;
+
+        Shared()
+        {
+            ring.setFillColor(sf::Color::Transparent); //no fill, only outline
+            ring.setOutlineThickness(6.f);             //outline thickness
+        }
+    };
 
+    RingWaveEffect(sf::Vector2f centerIn, float startRadiusIn, float endRadiusIn,
+                   float lifetimeSecondsIn, sf::Color outlineColorIn)
+        : center(centerIn), startRadius(startRadiusIn), endRadius(endRadiusIn), outlineColor(outlineColorIn),
+          radius(startRadiusIn)
+    {
         // protect against zero
         if (lifetimeSecondsIn <= 0.f)
             lifetime = 0.001f;
         else
             lifetime = lifetimeSecondsIn;
-
-        ringShape.setFillColor(sf::Color::Transparent); //no fill, only outline
-        ringShape.setOutlineThickness(6.f);             //outline thickness
-        ringShape.setOutlineColor(outlineColor);        //outline color
-        ringShape.setPosition(center);                  //fixed center position
-
-        // start at initial radius
-        ringShape.setRadius(startRadius);               //apply radius
-        ringShape.setOrigin(startRadius, startRadius);  //keep centered
     }
 
-
     // time since last frame in seconds
-    bool update(float frameTimeSec) override
+    bool update(float frameTimeSec)
     {
         elapsed += frameTimeSec;
 
@@ -237,23 +86,25 @@ class RingWaveEffect : public Effect
         if (progress > 1.f)
             progress = 1.f; //force high
 
-        float radius = startRadius + (endRadius - startRadius) * progress;  //grow radius
-        ringShape.setRadius(radius);    //apply radius
-        ringShape.setOrigin(radius, radius);    //keep centered
+        radius = startRadius + (endRadius - startRadius) * progress;  //grow radius
 
         // effect is done when we reached
         return elapsed >= lifetime;
     }
 
-    void draw(sf::RenderWindow& window) const override
+    void draw(sf::RenderWindow& window, Shared& shared) const
     {
-        window.draw(ringShape); //show circle outline
+        shared.ring.setRadius(radius);    //apply radius
+        shared.ring.setOrigin({radius, radius});    //keep centered
+        shared.ring.setPosition(center);
+        shared.ring.setOutlineColor(outlineColor);
+        window.draw(shared.ring); //show circle outline
     }
 };
 
 
 // solid color rectangle that covers view
-class ScreenFlashEffect : public Effect
+class ScreenFlashEffect
 {
     private:
     sf::Color fillColor;
@@ -262,6 +113,15 @@ class ScreenFlashEffect : public Effect
     float elapsed{0}; // time lived so far
 
     public:
+    static constexpr std::size_t CAPACITY = 8;
+    static constexpr std::size_t DRAWS = 1;
+
+    // one rectangle for every flash
+    struct Shared
+    {
+        sf::RectangleShape rect;
+    };
+
     ScreenFlashEffect(sf::Color fillColorIn, float lifetimeSecondsIn)
     {
         fillColor = fillColorIn;
@@ -274,50 +134,326 @@ class ScreenFlashEffect : public Effect
 
 
     // time since last frame in seconds
-    bool update(float frameTimeSec) override
+    bool update(float frameTimeSec)
     {
         elapsed += frameTimeSec;
         return elapsed >= lifetime;  // finished when elapsed >= lifetime
     }
 
-    void draw(sf::RenderWindow& window) const override
+    void draw(sf::RenderWindow& window, Shared& shared) const
     {
-        sf::RectangleShape rect;    //simple rectangle
+        const sf::View& view = window.getView();   //current view, no copy
+        shared.rect.setSize(view.getSize()); //fill the view
+        shared.rect.setOrigin({view.getSize().x * 0.5f, view.getSize().y * 0.5f});   //center origin
+        shared.rect.setPosition(view.getCenter());   //place at center
+        shared.rect.setFillColor(fillColor);   //solid color
+        window.draw(shared.rect);  //draw it
+    }
+};
 
-        sf::View view = window.getView();   //get current view
-        sf::Vector2f viewSize   = view.getSize(); //current view size
-        sf::Vector2f viewCenter = view.getCenter(); //current view center
+//play explosion sound when mine found and game end, on a voice of the preloaded audio
+class ExplosionSoundEffect
+{
+private:
+    Voice voice; // the voice playing it
+public:
+    static constexpr std::size_t CAPACITY = 32;
+    static constexpr std::size_t DRAWS = 0;
 
-        rect.setSize(viewSize); //fill the view
-        rect.setOrigin(viewSize.x * 0.5f, viewSize.y * 0.5f);   //center origin
-        rect.setPosition(viewCenter);   //place at center
-        rect.setFillColor(fillColor);   //solid color
+    struct Shared {};
 
-        window.draw(rect);  //draw it
+    explicit ExplosionSoundEffect(float vol = 100.f)
+        : voice(Audio::play(SoundId::Explosion, vol))
+    {
     }
+    //check if still playing each frame .if still playing return false
+    bool update(float)
+    {
+        return !Audio::playing(voice); // done when sound stops or its voice was taken
+    }
+
+    void draw(sf::RenderWindow&, Shared&) const { }
 };
 
-//play explosion sound when mine found and game end
-class ExplosionSoundEffect : public Effect
+// every effect of one type, made in place in slots that are sized once and never move,
+// so spawning never allocates;
+// a finished effect leaves by moving the last live slot number into its place
+template <class T>
+class EffectPool
 {
-private:
-    sf::SoundBuffer buffer; // holds audio samples
-    sf::Sound sound; // plays the buffer
-public:
-    ExplosionSoundEffect(const std::string& file, float vol = 100.f)
-        : buffer(), sound(buffer)
-    {   // load audio data
-        if (buffer.loadFromFile(file))
-            { // load audio data
-            sound.setVolume(vol);
-            sound.play(); // play once
+    private:
+    std::vector<std::optional<T>> slots;    // storage for CAPACITY effects
+    std::vector<std::uint64_t> born;        // spawn number of the effect in each slot, to find the oldest
+    std::vector<std::uint16_t> live;        // slots in use, in no particular order
+    std::vector<std::uint16_t> unused;      // slots free to spawn into
+    std::uint64_t spawned = 0;              // effects spawned so far
+    mutable typename T::Shared shared;      // drawing objects the whole type shares
+
+    public:
+    EffectPool() : slots(T::CAPACITY), born(T::CAPACITY, 0)
+    {
+        live.reserve(T::CAPACITY);
+        unused.reserve(T::CAPACITY);
+        for (std::size_t slot = T::CAPACITY; slot > 0; slot--)
+            unused.push_back(static_cast<std::uint16_t>(slot - 1));
+    }
+
+    // when every slot is busy the new effect takes over the oldest one; swap and pop leaves live
+    // unordered, so the oldest is found from the spawn numbers
+    template <class... Args>
+    T& spawn(Args&&... args)
+    {
+        std::uint16_t slot;
+        if (!unused.empty())
+        {
+            slot = unused.back();
+            unused.pop_back();
+            live.push_back(slot);
         }
+        else
+            slot = *std::min_element(live.begin(), live.end(), [&](std::uint16_t a, std::uint16_t b) { return born[a] < born[b]; });
+        born[slot] = spawned++;
+        slots[slot].emplace(std::forward<Args>(args)...);
+        return *slots[slot];
     }
-    //check if still playing each frame .if still playing return false
-    bool update(float) override
+
+    void update(float frameTimeSec)
+    {
+        std::size_t i = 0;
+        while (i < live.size())
+        {
+            std::optional<T>& effect = slots[live[i]];
+            if (effect->update(frameTimeSec))
+            {
+                effect.reset();
+                unused.push_back(live[i]);
+                live[i] = live.back();  //swap and pop, order inside a type does not matter
+                live.pop_back();
+            }
+            else
+                ++i;
+        }
+    }
+
+    void draw(sf::RenderWindow& window) const
+    {
+        for (std::uint16_t slot : live)
+            slots[slot]->draw(window, shared);
+        countDraw(T::DRAWS * live.size());
+    }
+
+    std::size_t size() const { return live.size(); }
+};
+
+// debris and sparks thrown out from a point, spawn<ParticleBurst>(center, count, color);
+// the bursts are not kept apart, their particles all go into the one system below
+struct ParticleBurst {};
+
+// the arrays every particle system works in, reserved once for the whole game; one board is on
+// screen at a time, so each new scene's system takes them over and clears them instead of
+// allocating a few megabytes again on every reset
+class ParticleStorage
+{
+    private:
+    ParticleStorage()
+    {
+        for (std::vector<float>* field : {&x, &y, &vx, &vy, &life, &lifetime, &radius, &weight})
+            field->reserve(CAPACITY);
+        color.reserve(CAPACITY);
+        vertices.reserve(CAPACITY * 6);
+    }
+
+    public:
+    static constexpr std::size_t CAPACITY = 32768;  // a burst past this only adds what fits
+
+    std::vector<float> x, y;            // position
+    std::vector<float> vx, vy;          // velocity
+    std::vector<float> life;            // seconds left
+    std::vector<float> lifetime;        // seconds it started with
+    std::vector<float> radius;          // half width of the square drawn
+    std::vector<float> weight;          // how much gravity pulls, debris falls and sparks drift
+    std::vector<sf::Color> color;
+    std::vector<sf::Vertex> vertices;   // two triangles per particle, rebuilt every draw
+
+    static ParticleStorage& instance()
+    {
+        static ParticleStorage storage;
+        return storage;
+    }
+
+    // drop every particle, the memory stays
+    void clear()
+    {
+        for (std::vector<float>* field : {&x, &y, &vx, &vy, &life, &lifetime, &radius, &weight})
+            field->clear();
+        color.clear();
+        vertices.clear();
+    }
+};
+
+// every particle of every burst, stored as one array per field so the step over them
+// is a plain loop over floats the compiler can vectorize, and drawn as one batch of triangles
+template <>
+class EffectPool<ParticleBurst>
+{
+    private:
+    static constexpr std::size_t CAPACITY = ParticleStorage::CAPACITY;
+    static constexpr float GRAVITY = 900.f;         // pixels per second squared
+    static constexpr float DRAG = 2.5f;             // fraction of speed lost per second
+
+    ParticleStorage& storage = ParticleStorage::instance();
+    std::vector<float>& x = storage.x;
+    std::vector<float>& y = storage.y;
+    std::vector<float>& vx = storage.vx;
+    std::vector<float>& vy = storage.vy;
+    std::vector<float>& life = storage.life;
+    std::vector<float>& lifetime = storage.lifetime;
+    std::vector<float>& radius = storage.radius;
+    std::vector<float>& weight = storage.weight;
+    std::vector<sf::Color>& color = storage.color;
+    std::vector<sf::Vertex>& vertices = storage.vertices;
+    std::uint64_t random = 0x9E3779B97F4A7C15ULL;
+    ParticleBurst burst;                // what spawn hands back, a burst has no state of its own
+
+    // uniform in [0, 1)
+    float next()
+    {
+        random = mixBits(random);
+        return static_cast<float>(random >> 40) / 16777216.f;
+    }
+
+    public:
+    // made with the scene that takes over, whatever the scene before it left in the air is dropped
+    EffectPool() { storage.clear(); }
+
+    EffectPool(const EffectPool&) = delete;
+    EffectPool& operator=(const EffectPool&) = delete;
+
+    // a quarter of the burst is slow heavy debris in the burst's colour, the rest fast bright sparks
+    ParticleBurst& spawn(sf::Vector2f center, int count, sf::Color tint)
+    {
+        const std::size_t room = CAPACITY - x.size();
+        const std::size_t added = std::min(room, static_cast<std::size_t>(std::max(count, 0)));
+        for (std::size_t i = 0; i < added; i++)
+        {
+            const bool debris = i % 4 == 0;
+            const float angle = next() * 6.2831853f;
+            const float speed = debris ? 100.f + next() * 250.f : 250.f + next() * 650.f;
+            const float seconds = debris ? 0.8f + next() * 0.7f : 0.3f + next() * 0.5f;
+            x.push_back(center.x);
+            y.push_back(center.y);
+            vx.push_back(std::cos(angle) * speed);
+            vy.push_back(std::sin(angle) * speed);
+            life.push_back(seconds);
+            lifetime.push_back(seconds);
+            radius.push_back(debris ? 2.f + next() * 2.f : 1.f + next());
+            weight.push_back(debris ? 1.f : 0.25f);
+            color.push_back(debris ? tint : sf::Color(255, 230, 150));
+        }
+        return burst;
+    }
+
+    void update(float frameTimeSec)
+    {
+        const std::size_t count = x.size();
+        const float slow = std::max(0.f, 1.f - DRAG * frameTimeSec);
+        const float fall = GRAVITY * frameTimeSec;
+        float* px = x.data();
+        float* py = y.data();
+        float* pvx = vx.data();
+        float* pvy = vy.data();
+        float* plife = life.data();
+        const float* pweight = weight.data();
+        //no branches or calls in here, one pass over each field
+        for (std::size_t i = 0; i < count; i++)
+        {
+            pvx[i] *= slow;
+            pvy[i] = pvy[i] * slow + fall * pweight[i];
+            px[i] += pvx[i] * frameTimeSec;
+            py[i] += pvy[i] * frameTimeSec;
+            plife[i] -= frameTimeSec;
+        }
+        //dead particles are swapped with the last one and dropped
+        std::size_t i = 0;
+        while (i < x.size())
+        {
+            if (life[i] > 0.f)
+            {
+                ++i;
+                continue;
+            }
+            const std::size_t last = x.size() - 1;
+            x[i] = x[last]; y[i] = y[last];
+            vx[i] = vx[last]; vy[i] = vy[last];
+            life[i] = life[last]; lifetime[i] = lifetime[last];
+            radius[i] = radius[last]; weight[i] = weight[last];
+            color[i] = color[last];
+            for (std::vector<float>* field : {&x, &y, &vx, &vy, &life, &lifetime, &radius, &weight})
+                field->pop_back();
+            color.pop_back();
+        }
+    }
+
+    // fade out over the particle's life, everything goes to the window in one draw call
+    void draw(sf::RenderWindow& window) const
+    {
+        const std::size_t count = x.size();
+        if (count == 0)
+            return;
+        vertices.resize(count * 6);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            sf::Color shade = color[i];
+            shade.a = static_cast<std::uint8_t>(255.f * std::min(1.f, life[i] / lifetime[i]));
+            const float left = x[i] - radius[i], right = x[i] + radius[i];
+            const float top = y[i] - radius[i], bottom = y[i] + radius[i];
+            sf::Vertex* quad = &vertices[i * 6];
+            quad[0] = {{left, top}, shade};
+            quad[1] = {{right, top}, shade};
+            quad[2] = {{left, bottom}, shade};
+            quad[3] = {{left, bottom}, shade};
+            quad[4] = {{right, top}, shade};
+            quad[5] = {{right, bottom}, shade};
+        }
+        window.draw(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles);
+        countDraw();
+    }
+
+    std::size_t size() const { return x.size(); }
+};
+
+// one pool per effect type, each type is updated and drawn as a batch in the order listed
+template <class... Types>
+class EffectSet
+{
+    private:
+    std::tuple<EffectPool<Types>...> pools;
+
+    public:
+    // create new effect of type T, with any arguments passed
+    template <class T, class... Args>
+    T& spawn(Args&&... args)
     {
-        return sound.getStatus() == sf::SoundSource::Status::Stopped; // done when sound stops
+        return std::get<EffectPool<T>>(pools).spawn(std::forward<Args>(args)...);
     }
 
-    void draw(sf::RenderWindow&) const override { }
+    // advance and remove finished
+    void update(float frameTimeSec)
+    {
+        std::apply([&](auto&... pool) { (pool.update(frameTimeSec), ...); }, pools);
+    }
+
+    // draw all active effects
+    void draw(sf::RenderWindow& window) const
+    {
+        std::apply([&](const auto&... pool) { (pool.draw(window), ...); }, pools);
+    }
+
+    std::size_t size() const
+    {
+        return std::apply([](const auto&... pool) { return (pool.size() + ...); }, pools);
+    }
 };
+
+// effects manager, particles are drawn over rings and flashes over both
+using Effects = EffectSet<RingWaveEffect, ParticleBurst, ScreenFlashEffect, ExplosionSoundEffect>;
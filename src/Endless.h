@@ -0,0 +1,208 @@
+#ifndef ENDLESS_H
+#define ENDLESS_H
+#include <SFML/Graphics.hpp>
+#include <iostream>
+#include <string>
+#include "Effects.h"
+#include "Hud.h"
+#include "BoardRenderer.h"
+#include "core/ChunkedBoard.h"
+#include "HitTest.h"
+#include "Scene.h"
+void difficulty(SceneManager& scenes);
+
+// a board with no edges seen through the 30 by 30 hard frame, the arrow keys or WASD move around it
+class EndlessScene : public Scene
+{
+private:
+    //squares on screen and where they are drawn
+    static constexpr int viewRows=30;
+    static constexpr int viewColumns=30;
+    static constexpr int cellSize=30;
+    const sf::Vector2i origin{511,93};
+    //squares a flood may open per frame, a big area is opened over a few frames instead of stalling one
+    static constexpr int floodBudget=4096;
+
+    ChunkedBoard board;
+    //board square shown in the top left corner of the view, the game starts centred on square 0,0
+    int left=-viewRows/2;
+    int top=-viewColumns/2;
+    Hud hud;
+    std::size_t scoreLine = 0;
+    //batched tiles for the squares in view
+    BoardRenderer boardTiles;
+    //every tile in view is picked again at the start, after moving and when the game ends
+    bool viewChanged=true;
+    //effect manager
+    Effects effects;
+
+    // bring one board square's tile up to date if it is in view
+    void showSquare(int r, int c)
+    {
+        if (r < left || r >= left + viewRows || c < top || c >= top + viewColumns)
+            return;
+        int mineCount = board.isMine(r,c) ? 0 : board.mineCount(r,c);
+        boardTiles.setTile(r - left, c - top, cellTile(board.isMine(r,c), board.isOpen(r,c), board.isFlagged(r,c), mineCount, board.state()));
+    }
+
+    void updateScore()
+    {
+        hud.setNumber(scoreLine, board.score());
+    }
+
+    //move the view by whole squares
+    void move(int across, int down)
+    {
+        left+=across;
+        top+=down;
+        viewChanged=true;
+    }
+
+public:
+    EndlessScene()
+        : board(Seeds::next(), 0.16),
+          boardTiles("Minesweeper_hard.png", "Hard", viewRows, viewColumns, sf::Vector2f(origin), static_cast<float>(cellSize))
+    {
+        std::cout << "seed " << Seeds::current() << std::endl;
+        scoreLine = hud.addNumber(board.score(), 60, {765.f,10.f});
+    }
+
+    void handle(const sf::Event& event, SceneManager& scenes) override
+    {
+        if (const auto* keyPressed = event.getIf<sf :: Event :: KeyPressed>())
+        {
+            //closes the game if the ESC key is pressed
+            if (keyPressed->scancode == sf :: Keyboard :: Scancode :: Escape)
+                scenes.quit();
+            //move the view one square at a time
+            else if (keyPressed->scancode == sf::Keyboard::Scancode::Left || keyPressed->scancode == sf::Keyboard::Scancode::A)
+                move(-1, 0);
+            else if (keyPressed->scancode == sf::Keyboard::Scancode::Right || keyPressed->scancode == sf::Keyboard::Scancode::D)
+                move(1, 0);
+            else if (keyPressed->scancode == sf::Keyboard::Scancode::Up || keyPressed->scancode == sf::Keyboard::Scancode::W)
+                move(0, -1);
+            else if (keyPressed->scancode == sf::Keyboard::Scancode::Down || keyPressed->scancode == sf::Keyboard::Scancode::S)
+                move(0, 1);
+        }
+        else if (const auto* mouseButtonReleased = event.getIf<sf::Event::MouseButtonReleased>())
+        {
+            //where the click happened, taken from the event itself
+            const sf::Vector2i click = mouseButtonReleased->position;
+            //find the square under the click with one divide
+            std::optional<Cell> clicked = cellAt(click, origin, cellSize, viewRows, viewColumns);
+            if (mouseButtonReleased->button == sf::Mouse::Button::Right)
+            {
+                if (clicked && board.toggleFlag(left + clicked->rows, top + clicked->columns))
+                    showSquare(left + clicked->rows, top + clicked->columns);
+            }
+            if (mouseButtonReleased->button != sf::Mouse::Button::Left)
+                return;
+            //difficulty screen is shown again
+            if (BACK_BUTTON.contains(click))
+            {
+                difficulty(scenes);
+                return;
+            }
+            //a new endless board
+            if (RESET_BUTTON.contains(click))
+            {
+                scenes.change<EndlessScene>();
+                return;
+            }
+            if (!clicked)
+                return;
+            const ClickResult* result;
+            {
+                ProfileScope timer(Zone::Rules);
+                result = &board.open(left + clicked->rows, top + clicked->columns);
+            }
+            const ClickResult& opened = *result;
+            if (!opened.accepted)
+                return;
+            updateScore();
+            if (opened.ended)
+                viewChanged=true;
+            for (const Cell& cell : opened.changed)
+                showSquare(cell.rows, cell.columns);
+            if (opened.hitMine)
+            {
+                //location of mine
+                float cellCenterX = origin.x + static_cast<float>(cellSize*clicked->rows) + cellSize/2.f;
+                float cellCenterY = origin.y + static_cast<float>(cellSize*clicked->columns) + cellSize/2.f;
+                //trigger effects
+                effects.spawn<ExplosionSoundEffect>();
+                effects.spawn<RingWaveEffect>(sf::Vector2f{cellCenterX,cellCenterY}, 0.f, 600.f, 0.1f, sf::Color(255,80,30));
+                effects.spawn<ParticleBurst>(sf::Vector2f{cellCenterX,cellCenterY}, 2000, sf::Color(120,70,40));
+                effects.spawn<ScreenFlashEffect>(sf::Color(255,255,255,220), 0.05f);
+            }
+        }
+    }
+
+    void update(float secsSinceLastFrame) override
+    {
+        //update effects
+        {
+            ProfileScope timer(Zone::EffectsUpdate);
+            effects.update(secsSinceLastFrame);
+        }
+
+        //carry on any flood, a little each frame
+        if (board.spreading())
+        {
+            for (const Cell& cell : board.spread(floodBudget))
+                showSquare(cell.rows, cell.columns);
+            updateScore();
+        }
+        //after moving, pick every tile in view again and let go of chunks that are far away and unplayed
+        if (viewChanged)
+        {
+            for (int rows=left; rows<left+viewRows; rows++)
+            {
+                for (int columns=top; columns<top+viewColumns; columns++)
+                {
+                    showSquare(rows, columns);
+                }
+            }
+            board.evict(floorDiv(left, CHUNK_SIZE) - 1, floorDiv(top, CHUNK_SIZE) - 1,
+                        floorDiv(left + viewRows - 1, CHUNK_SIZE) + 1, floorDiv(top + viewColumns - 1, CHUNK_SIZE) + 1);
+            viewChanged=false;
+        }
+    }
+
+    bool animating() const override
+    {
+        return effects.size() > 0 || board.spreading();
+    }
+
+    void draw(sf::RenderWindow& window) override
+    {
+        {
+            //cached background and board, one draw call when nothing changed
+            ProfileScope timer(Zone::Board);
+            boardTiles.draw(window);
+        }
+        {
+            ProfileScope timer(Zone::Hud);
+            hud.draw(window);
+            //one cursor query per frame for the button highlights
+            sf::Vector2i mouse = sf::Mouse::getPosition(window);
+            if (BACK_BUTTON.contains(mouse))
+                drawTile(window, "backButtonHighlighted.png", 173, 77, 17.f, 14.f);
+            else
+                drawTile(window, "backButton.png", 173, 77, 17.f, 14.f);
+
+            if (RESET_BUTTON.contains(mouse))
+                drawTile(window, "resetButtonHighlighted.png", 173, 77, 1730.f, 14.f);
+            else
+                drawTile(window, "resetButton.png", 173, 77, 1730.f, 14.f);
+        }
+        ProfileScope timer(Zone::EffectsDraw);
+        effects.draw(window);
+    }
+};
+
+inline void Endless(SceneManager& scenes)
+{
+    scenes.change<EndlessScene>();
+}
+#endif //ENDLESS_H
@@ -0,0 +1,42 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <optional>
+#include "core/BitBoard.h"
+#include "core/Preset.h"
+
+// buttons shared by the screens, a button covers [position, position + size)
+inline const sf::IntRect BACK_BUTTON({17,14}, {173,76});
+inline const sf::IntRect RESET_BUTTON({1731,14}, {171,76});
+inline const sf::IntRect PLAY_BUTTON({751,680}, {425,101});
+inline const sf::IntRect DEMOLITION_BUTTON({751,817}, {425,94});
+inline const sf::IntRect EXIT_BUTTON({751,953}, {425,92});
+inline const sf::IntRect EASY_BUTTON({746,189}, {425,131});
+inline const sf::IntRect MEDIUM_BUTTON({747,481}, {428,125});
+inline const sf::IntRect HARD_BUTTON({750,743}, {420,131});
+
+// square under a pixel, found with one divide per axis instead of testing every square;
+// rows runs left to right and columns top to bottom, like the board is drawn
+inline std::optional<Cell> cellAt(sf::Vector2i position, sf::Vector2i origin, int cellSize, int rowsCount, int columnsCount)
+{
+    int x = position.x - origin.x;
+    int y = position.y - origin.y;
+    //left of or above the board
+    if (x < 0 || y < 0)
+        return std::nullopt;
+    Cell cell{x / cellSize, y / cellSize};
+    //right of or below the board
+    if (cell.rows >= rowsCount || cell.columns >= columnsCount)
+        return std::nullopt;
+    return cell;
+}
+
+// the same for a preset board, the square under each pixel was worked out at compile time
+inline std::optional<Cell> cellAt(sf::Vector2i position, const BoardLayout& layout)
+{
+    //one compare per axis catches both sides, a pixel left of or above the board wraps to a huge number
+    const unsigned x = static_cast<unsigned>(position.x - layout.originX);
+    const unsigned y = static_cast<unsigned>(position.y - layout.originY);
+    if (x >= static_cast<unsigned>(layout.rows * layout.cellSize) || y >= static_cast<unsigned>(layout.columns * layout.cellSize))
+        return std::nullopt;
+    return Cell{layout.rowAt[x], layout.columnAt[y]};
+}
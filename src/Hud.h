@@ -0,0 +1,121 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Assets.h"
+#include "Profiler.h"
+
+// the one font every screen writes with, opened once at startup
+inline const sf::Font& hudFont()
+{
+    return Assets::font("CascadiaCode.ttf");
+}
+
+// text drawn over a screen (score, lives, options); a line's string is only set again when what it
+// shows changes, and the lines are kept in a small render texture that is drawn with one call
+class Hud
+{
+private:
+    // one piece of text, a number line remembers the value it shows
+    struct Line
+    {
+        sf::Text text;
+        bool number;
+        long long shown;
+    };
+
+    std::vector<Line> lines;
+    sf::RenderTexture cache;    // every line drawn over transparent, only grows
+    sf::Vector2f corner;        // where the top left of the cache goes on screen
+    sf::Vector2i area;          // part of the cache the lines cover
+    bool stale = true;          // a line changed since the cache was drawn
+
+    static void showNumber(sf::Text& text, long long value)
+    {
+        std::array<char, 24> digits{};
+        *std::to_chars(digits.data(), digits.data() + digits.size() - 1, value).ptr = '\0';
+        text.setString(digits.data());
+    }
+
+    void redraw()
+    {
+        //the box around every line, whole pixels so the text is not resampled
+        float left = 1e9f, top = 1e9f, right = -1e9f, bottom = -1e9f;
+        for (const Line& line : lines)
+        {
+            const sf::FloatRect bounds = line.text.getGlobalBounds();
+            left = std::min(left, bounds.position.x);
+            top = std::min(top, bounds.position.y);
+            right = std::max(right, bounds.position.x + bounds.size.x);
+            bottom = std::max(bottom, bounds.position.y + bounds.size.y);
+        }
+        corner = {std::floor(left) - 2.f, std::floor(top) - 2.f};
+        area = {static_cast<int>(std::ceil(right - corner.x)) + 2, static_cast<int>(std::ceil(bottom - corner.y)) + 2};
+        const sf::Vector2u size = cache.getSize();
+        if (static_cast<unsigned>(area.x) > size.x || static_cast<unsigned>(area.y) > size.y)
+            cache = sf::RenderTexture({std::max(size.x, static_cast<unsigned>(area.x) + 64), std::max(size.y, static_cast<unsigned>(area.y))});
+        cache.setView(sf::View(sf::FloatRect(corner, sf::Vector2f(cache.getSize()))));
+        cache.clear(sf::Color::Transparent);
+        for (const Line& line : lines)
+            cache.draw(line.text);
+        cache.display();
+        countDraw(lines.size());
+        stale = false;
+    }
+
+public:
+    // a line of fixed text, the returned index changes it later
+    std::size_t addLabel(const std::string& string, unsigned size, sf::Vector2f position, sf::Color color = sf::Color::Black)
+    {
+        lines.push_back({sf::Text(hudFont(), string, size), false, 0});
+        lines.back().text.setPosition(position);
+        lines.back().text.setFillColor(color);
+        stale = true;
+        return lines.size() - 1;
+    }
+
+    // a line showing a number, the returned index changes it later
+    std::size_t addNumber(long long value, unsigned size, sf::Vector2f position, sf::Color color = sf::Color::Black)
+    {
+        const std::size_t line = addLabel("", size, position, color);
+        lines[line].number = true;
+        lines[line].shown = value;
+        showNumber(lines[line].text, value);
+        return line;
+    }
+
+    void setLabel(std::size_t line, const std::string& string)
+    {
+        lines[line].text.setString(string);
+        stale = true;
+    }
+
+    // show a new number, nothing is redone when it is the one already shown
+    void setNumber(std::size_t line, long long value)
+    {
+        if (lines[line].shown == value)
+            return;
+        lines[line].shown = value;
+        showNumber(lines[line].text, value);
+        stale = true;
+    }
+
+    // draw the cached lines, redrawing the cache first if one changed; the cache holds
+    // premultiplied colour, so it is blended that way to look the same as drawing the text directly
+    void draw(sf::RenderTarget& window)
+    {
+        if (lines.empty())
+            return;
+        if (stale)
+            redraw();
+        sf::Sprite sprite(cache.getTexture(), sf::IntRect({0, 0}, area));
+        sprite.setPosition(corner);
+        window.draw(sprite, sf::RenderStates(sf::BlendMode(sf::BlendMode::Factor::One, sf::BlendMode::Factor::OneMinusSrcAlpha)));
+        countDraw();
+    }
+};
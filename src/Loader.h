@@ -0,0 +1,174 @@
+#pragma once
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+// an image or sound decoded off the render thread, both empty when the file could not be read
+struct DecodedAsset
+{
+    std::optional<sf::Image> image;
+    std::optional<sf::SoundBuffer> sound;
+};
+
+// decodes assets on one worker thread in the order they were asked for; nothing here touches the
+// gpu, the render thread takes the decoded images and makes the textures itself
+class AssetLoader
+{
+private:
+    struct Job
+    {
+        std::string name;
+        std::function<void(DecodedAsset&)> decode;
+    };
+
+    std::mutex lock;
+    std::condition_variable wake;       // a job was queued or the loader is stopping
+    std::condition_variable decoded;    // a job finished
+    std::deque<Job> queue;              // waiting to be decoded
+    std::unordered_set<std::string> known;  // queued, being decoded or decoded and not taken yet
+    std::deque<std::pair<std::string, DecodedAsset>> done;  // decoded, oldest first
+    bool stopping = false;
+    std::thread worker;                 // last, so it starts once everything above is made
+
+    void run()
+    {
+        std::unique_lock<std::mutex> held(lock);
+        while (true)
+        {
+            wake.wait(held, [this] { return stopping || !queue.empty(); });
+            if (stopping)
+                return;
+            Job job = std::move(queue.front());
+            queue.pop_front();
+            held.unlock();
+            DecodedAsset asset;
+            //sfml throws on a file it cannot read, the asset is then left empty for the render thread to retry
+            try
+            {
+                job.decode(asset);
+            }
+            catch (...)
+            {
+                asset = DecodedAsset();
+            }
+            held.lock();
+            done.emplace_back(std::move(job.name), std::move(asset));
+            decoded.notify_all();
+        }
+    }
+
+    // lock held
+    void moveToFront(const std::string& name)
+    {
+        auto queued = std::find_if(queue.begin(), queue.end(), [&](const Job& job) { return job.name == name; });
+        if (queued != queue.end() && queued != queue.begin())
+            std::rotate(queue.begin(), queued, queued + 1);
+    }
+
+    // lock held, nothing when the asset is not decoded yet
+    std::optional<DecodedAsset> takeDone(const std::string& name)
+    {
+        auto found = std::find_if(done.begin(), done.end(), [&](const auto& entry) { return entry.first == name; });
+        if (found == done.end())
+            return std::nullopt;
+        DecodedAsset asset = std::move(found->second);
+        done.erase(found);
+        known.erase(name);
+        return asset;
+    }
+
+public:
+    AssetLoader() : worker([this] { run(); }) {}
+
+    ~AssetLoader()
+    {
+        {
+            std::lock_guard<std::mutex> held(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        worker.join();
+    }
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // queue a decode, nothing happens when the name is already on its way
+    void request(const std::string& name, std::function<void(DecodedAsset&)> decode)
+    {
+        {
+            std::lock_guard<std::mutex> held(lock);
+            if (!known.insert(name).second)
+                return;
+            queue.push_back({name, std::move(decode)});
+        }
+        wake.notify_one();
+    }
+
+    // true while the name is queued, decoding or decoded and not taken
+    bool has(const std::string& name)
+    {
+        std::lock_guard<std::mutex> held(lock);
+        return known.count(name) > 0;
+    }
+
+    // take one asset, waiting for it if it is not decoded yet; a queued asset is moved to the front
+    // so the wait is only ever for its own decode. nothing when it was never asked for
+    std::optional<DecodedAsset> take(const std::string& name)
+    {
+        std::unique_lock<std::mutex> held(lock);
+        if (!known.count(name))
+            return std::nullopt;
+        moveToFront(name);
+        while (true)
+        {
+            if (std::optional<DecodedAsset> asset = takeDone(name))
+                return asset;
+            decoded.wait(held);
+        }
+    }
+
+    // take one asset if it is decoded, without waiting
+    std::optional<DecodedAsset> takeReady(const std::string& name)
+    {
+        std::lock_guard<std::mutex> held(lock);
+        return takeDone(name);
+    }
+
+    // decode a queued asset next, ahead of everything asked for before it
+    void hurry(const std::string& name)
+    {
+        std::lock_guard<std::mutex> held(lock);
+        moveToFront(name);
+    }
+
+    // take the oldest decoded asset without waiting
+    std::optional<std::pair<std::string, DecodedAsset>> takeReady()
+    {
+        std::lock_guard<std::mutex> held(lock);
+        if (done.empty())
+            return std::nullopt;
+        std::pair<std::string, DecodedAsset> entry = std::move(done.front());
+        done.pop_front();
+        known.erase(entry.first);
+        return entry;
+    }
+
+    // assets asked for and not taken yet
+    std::size_t outstanding()
+    {
+        std::lock_guard<std::mutex> held(lock);
+        return known.size();
+    }
+};
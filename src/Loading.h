@@ -0,0 +1,80 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Assets.h"
+#include "BoardScreen.h"
+#include "Hud.h"
+#include "Scene.h"
+
+// shown while a board's images are decoded in the background and uploaded a strip at a time,
+// then hands over to the board; a board whose images are all in memory never shows it. Only the
+// board's own images are waited for, anything else prefetched carries on loading after
+class LoadingScene : public Scene
+{
+private:
+    static inline const sf::Vector2f BAR_CORNER{660.f, 560.f};
+    static inline const sf::Vector2f BAR_SIZE{600.f, 24.f};
+
+    SceneManager& scenes;   // the board is asked for from update, which is not given the manager
+    BoardConfig config;
+    std::vector<std::string> assets;    // the board's images
+    std::size_t total;      // of them still loading when the screen opened
+    float loaded = 0.f;     // share of them done
+    Hud hud;
+
+public:
+    LoadingScene(SceneManager& scenesIn, const BoardConfig& configIn)
+        : scenes(scenesIn), config(configIn), assets(boardAssets(config)),
+          total(std::max<std::size_t>(1, Assets::loading(assets)))
+    {
+        hud.addLabel("Loading", 50, {BAR_CORNER.x, BAR_CORNER.y - 80.f}, sf::Color::White);
+    }
+
+    void handle(const sf::Event& event, SceneManager& scenesIn) override
+    {
+        //closes the game if the user presses the ESC key
+        if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>())
+        {
+            if (keyPressed->scancode == sf::Keyboard::Scancode::Escape)
+                scenesIn.quit();
+        }
+    }
+
+    void update(float secsSinceLastFrame) override
+    {
+        (void)secsSinceLastFrame;
+        if (Assets::upload(sf::seconds(UPLOAD_BUDGET), assets))
+            scenes.change<BoardScene>(config);
+        else
+            loaded = 1.f - std::min(1.f, static_cast<float>(Assets::loading(assets)) / static_cast<float>(total));
+    }
+
+    bool animating() const override { return true; }
+
+    void draw(sf::RenderWindow& window) override
+    {
+        window.clear(sf::Color::Black);
+        sf::RectangleShape bar(BAR_SIZE);
+        bar.setPosition(BAR_CORNER);
+        bar.setFillColor(sf::Color(60, 60, 60));
+        window.draw(bar);
+        bar.setSize({BAR_SIZE.x * loaded, BAR_SIZE.y});
+        bar.setFillColor(sf::Color::White);
+        window.draw(bar);
+        countDraw(2);
+        hud.draw(window);
+    }
+};
+
+// open a board, by way of the loading screen when its images are not all in memory yet
+inline void playBoard(SceneManager& scenes, const BoardConfig& config)
+{
+    prefetchBoard(config);
+    if (Assets::loading(boardAssets(config)) == 0)
+        scenes.change<BoardScene>(config);
+    else
+        scenes.change<LoadingScene>(scenes, config);
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include "Hud.h"
+#include "Race.h"
+#include "Scene.h"
+void title(SceneManager& scenes);
+
+// shown from joining a race until the server starts it, which is once every player is in;
+// ESC gives up on the race and goes back to the title screen
+class LobbyScene : public Scene
+{
+private:
+    using Start = void (*)(SceneManager&, std::unique_ptr<RaceLink>);
+
+    SceneManager& scenes;   // the board is asked for from update, which is not given the manager
+    std::unique_ptr<RaceLink> link;
+    Start start;            // opens the race's board once the server has sent it
+    Hud hud;
+
+public:
+    LobbyScene(SceneManager& scenesIn, std::unique_ptr<RaceLink> linkIn, Start startIn)
+        : scenes(scenesIn), link(std::move(linkIn)), start(startIn)
+    {
+        hud.addLabel("Waiting for the other player", 50, {560.f, 480.f}, sf::Color::White);
+        hud.addLabel("ESC to give up", 30, {560.f, 560.f}, sf::Color(180, 180, 180));
+    }
+
+    void handle(const sf::Event& event, SceneManager& scenesIn) override
+    {
+        //leaving closes the connection, and for the host the server with it
+        if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>())
+        {
+            if (keyPressed->scancode == sf::Keyboard::Scancode::Escape)
+                title(scenesIn);
+        }
+    }
+
+    void update(float secsSinceLastFrame) override
+    {
+        (void)secsSinceLastFrame;
+        if (!link)
+            return;
+        const JoinState state = link->poll();
+        if (state == JoinState::Started)
+            start(scenes, std::move(link));
+        else if (state == JoinState::Failed)
+        {
+            std::cerr << "the race did not start" << std::endl;
+            link.reset();
+            title(scenes);
+        }
+    }
+
+    // the server's start can come at any moment, so keep checking
+    bool animating() const override { return true; }
+
+    void draw(sf::RenderWindow& window) override
+    {
+        window.clear(sf::Color::Black);
+        hud.draw(window);
+    }
+};
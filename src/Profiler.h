@@ -0,0 +1,315 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+// parts of a frame that are timed, in the order the overlay lists them
+enum class Zone : std::uint8_t
+{
+    Events,         // pollEvent
+    Input,          // the scene handling events
+    Rules,          // board clicks: flood, scoring, win check; on a board this is the rules thread's steps since the last frame
+    Update,         // the scene's update, effects update included
+    Board,          // board and background
+    Hud,            // score, lives, buttons and other text
+    EffectsUpdate,
+    EffectsDraw,
+    Display,        // window.display, includes the wait for the frame limit
+    Count
+};
+
+// things counted per frame
+enum class Counter : std::uint8_t
+{
+    DrawCalls,
+    TextureLoads,
+    Allocations,
+    Count
+};
+
+// operator new in main.cpp adds to this, so it is kept outside the profiler and never allocates itself;
+// each thread counts its own, so the render thread's frames leave out the loader, generator and rules threads
+inline thread_local std::uint64_t allocationCount = 0;
+
+// frame timings and counters, shown with F3 and optionally written to a file every frame;
+// a .json file is a Chrome trace (chrome://tracing, Perfetto), anything else is CSV with one row per frame
+class Profiler
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t ZONES = static_cast<std::size_t>(Zone::Count);
+    static constexpr std::size_t COUNTERS = static_cast<std::size_t>(Counter::Count);
+    static constexpr std::size_t HISTORY = 60;     // frames the overlay averages over
+    static constexpr std::size_t LATENCIES = 256;  // clicks the overlay's latency percentiles cover
+    static constexpr std::size_t SHOWN = 16;       // clicks one frame can time, more in one frame are rare
+    static constexpr const char* ZONE_NAMES[ZONES] = {"events", "input", "rules", "update", "board", "hud",
+                                                      "effects_update", "effects_draw", "display"};
+    static constexpr const char* COUNTER_NAMES[COUNTERS] = {"draw_calls", "texture_loads", "allocations"};
+
+    // one timed scope, kept for the Chrome trace
+    struct Span
+    {
+        Zone zone;
+        Clock::time_point start;
+        Clock::duration length;
+    };
+
+    Clock::time_point started = Clock::now();   // trace times are counted from here
+    Clock::time_point frameStart;
+    std::array<double, ZONES> zoneTimes{};      // seconds this frame
+    std::array<std::uint64_t, COUNTERS> counts{};
+    std::uint64_t allocationsAtStart = 0;
+    std::array<std::array<double, ZONES + 1>, HISTORY> history{};   // zone times and frame time
+    std::array<std::array<std::uint64_t, COUNTERS>, HISTORY> countHistory{};
+    std::uint64_t frames = 0;
+    std::array<double, LATENCIES> latencies{};  // seconds from reading a click to showing its result
+    std::uint64_t clicks = 0;
+    std::array<Clock::time_point, SHOWN> shown{};   // input times of clicks drawn this frame
+    std::size_t shownCount = 0;
+    std::vector<Span> spans;                    // this frame's scopes when tracing
+    std::ofstream file;
+    bool trace = false;                         // file is a Chrome trace rather than CSV
+    bool firstEvent = true;                     // the trace's first event has no comma before it
+    bool overlay = false;                       // F3 shows the numbers
+    std::optional<sf::Text> text;               // made once the game hands over its font
+    std::string lines;
+
+    static Profiler& instance()
+    {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    static double micros(Clock::duration length)
+    {
+        return std::chrono::duration<double, std::micro>(length).count();
+    }
+
+    const char* separator()
+    {
+        const char* before = firstEvent ? "" : ",\n";
+        firstEvent = false;
+        return before;
+    }
+
+    void writeFrame(double frameSeconds)
+    {
+        if (!file)
+            return;
+        if (trace)
+        {
+            //complete events, one per scope, with the whole frame on a second track
+            char event[160];
+            for (const Span& span : spans)
+            {
+                std::snprintf(event, sizeof(event), "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.1f,\"dur\":%.1f}",
+                              separator(), ZONE_NAMES[static_cast<std::size_t>(span.zone)], micros(span.start - started), micros(span.length));
+                file << event;
+            }
+            std::snprintf(event, sizeof(event), "%s{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":%.1f,\"dur\":%.1f}",
+                          separator(), micros(frameStart - started), frameSeconds * 1e6);
+            file << event;
+            spans.clear();
+            return;
+        }
+        file << frames << ',' << frameSeconds * 1e3;
+        for (double seconds : zoneTimes)
+            file << ',' << seconds * 1e3;
+        for (std::uint64_t count : counts)
+            file << ',' << count;
+        file << '\n';
+    }
+
+    // averages of the last frames, rebuilt a few times a second rather than every frame
+    void refreshText()
+    {
+        const std::size_t kept = static_cast<std::size_t>(std::min<std::uint64_t>(frames, HISTORY));
+        if (kept == 0)
+            return;
+        std::array<double, ZONES + 1> times{};
+        std::array<double, COUNTERS> averages{};
+        for (std::size_t frame = 0; frame < kept; frame++)
+        {
+            for (std::size_t zone = 0; zone <= ZONES; zone++)
+                times[zone] += history[frame][zone];
+            for (std::size_t counter = 0; counter < COUNTERS; counter++)
+                averages[counter] += static_cast<double>(countHistory[frame][counter]);
+        }
+        char line[64];
+        std::snprintf(line, sizeof(line), "frame %6.2f ms  %5.1f fps\n", times[ZONES] / kept * 1e3,
+                      times[ZONES] > 0 ? kept / times[ZONES] : 0.0);
+        lines = line;
+        for (std::size_t zone = 0; zone < ZONES; zone++)
+        {
+            std::snprintf(line, sizeof(line), "%-15s %6.3f ms\n", ZONE_NAMES[zone], times[zone] / kept * 1e3);
+            lines += line;
+        }
+        for (std::size_t counter = 0; counter < COUNTERS; counter++)
+        {
+            std::snprintf(line, sizeof(line), "%-15s %6.1f\n", COUNTER_NAMES[counter], averages[counter] / kept);
+            lines += line;
+        }
+        //click to present over the last clicks, sorted copy so the ring keeps its order
+        const std::size_t timed = static_cast<std::size_t>(std::min<std::uint64_t>(clicks, LATENCIES));
+        if (timed > 0)
+        {
+            std::array<double, LATENCIES> sorted = latencies;
+            std::sort(sorted.begin(), sorted.begin() + timed);
+            auto percentile = [&](double share) { return sorted[std::min(timed - 1, static_cast<std::size_t>(share * timed))] * 1e3; };
+            std::snprintf(line, sizeof(line), "click p50 %5.1f p95 %5.1f p99 %5.1f ms\n", percentile(0.5), percentile(0.95), percentile(0.99));
+            lines += line;
+        }
+        if (text)
+            text->setString(lines);
+    }
+
+    Profiler()
+    {
+        lines.reserve(1024);
+        spans.reserve(256);
+    }
+
+public:
+    ~Profiler()
+    {
+        if (file && trace)
+            file << "\n]\n";
+    }
+
+    // write every frame to path from now on
+    static bool writeTo(const std::string& path)
+    {
+        Profiler& profiler = instance();
+        profiler.file.open(path);
+        if (!profiler.file)
+            return false;
+        profiler.trace = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+        if (profiler.trace)
+            profiler.file << "[\n";
+        else
+        {
+            profiler.file << "frame,frame_ms";
+            for (const char* name : ZONE_NAMES)
+                profiler.file << ',' << name << "_ms";
+            for (const char* name : COUNTER_NAMES)
+                profiler.file << ',' << name;
+            profiler.file << '\n';
+        }
+        return true;
+    }
+
+    // the font the overlay is written in, which has to outlive the profiler
+    static void setFont(const sf::Font& font)
+    {
+        sf::Text& text = instance().text.emplace(font);
+        text.setCharacterSize(18);
+        text.setFillColor(sf::Color(255, 255, 120));
+        text.setOutlineColor(sf::Color::Black);
+        text.setOutlineThickness(2.f);
+        text.setPosition({20.f, 110.f});
+        text.setString(instance().lines);
+    }
+
+    static void toggleOverlay() { instance().overlay = !instance().overlay; }
+
+    static bool overlayShown() { return instance().overlay; }
+
+    static void beginFrame()
+    {
+        Profiler& profiler = instance();
+        profiler.frameStart = Clock::now();
+        profiler.zoneTimes.fill(0);
+        profiler.counts.fill(0);
+        profiler.allocationsAtStart = allocationCount;
+    }
+
+    static void endFrame()
+    {
+        Profiler& profiler = instance();
+        const Clock::time_point now = Clock::now();
+        const double frameSeconds = std::chrono::duration<double>(now - profiler.frameStart).count();
+        for (std::size_t click = 0; click < profiler.shownCount; click++)
+            profiler.latencies[profiler.clicks++ % LATENCIES] = std::chrono::duration<double>(now - profiler.shown[click]).count();
+        profiler.shownCount = 0;
+        profiler.counts[static_cast<std::size_t>(Counter::Allocations)] =
+            allocationCount - profiler.allocationsAtStart;
+        std::array<double, ZONES + 1>& slot = profiler.history[profiler.frames % HISTORY];
+        for (std::size_t zone = 0; zone < ZONES; zone++)
+            slot[zone] = profiler.zoneTimes[zone];
+        slot[ZONES] = frameSeconds;
+        profiler.countHistory[profiler.frames % HISTORY] = profiler.counts;
+        profiler.writeFrame(frameSeconds);
+        profiler.frames++;
+        if (profiler.overlay && profiler.frames % 15 == 0)
+            profiler.refreshText();
+    }
+
+    static void add(Zone zone, Clock::time_point start, Clock::time_point end)
+    {
+        Profiler& profiler = instance();
+        profiler.zoneTimes[static_cast<std::size_t>(zone)] += std::chrono::duration<double>(end - start).count();
+        if (profiler.trace && profiler.file)
+            profiler.spans.push_back({zone, start, end - start});
+    }
+
+    // time spent outside the render thread for a zone this frame, it shows in the overlay and the CSV
+    // but not the trace, which only has the render thread's own scopes
+    static void addTime(Zone zone, double seconds)
+    {
+        instance().zoneTimes[static_cast<std::size_t>(zone)] += seconds;
+    }
+
+    // a click read at inputTime has its result in this frame, it is timed once the frame is shown
+    static void inputShown(Clock::time_point inputTime)
+    {
+        Profiler& profiler = instance();
+        if (profiler.shownCount < SHOWN)
+            profiler.shown[profiler.shownCount++] = inputTime;
+    }
+
+    static void count(Counter counter, std::uint64_t amount = 1)
+    {
+        instance().counts[static_cast<std::size_t>(counter)] += amount;
+    }
+
+    // the numbers in the top left corner while F3 is on, drawn with the default view
+    static void drawOverlay(sf::RenderWindow& window)
+    {
+        Profiler& profiler = instance();
+        if (!profiler.overlay || !profiler.text)
+            return;
+        if (profiler.lines.empty())
+            profiler.refreshText();
+        window.setView(window.getDefaultView());
+        window.draw(*profiler.text);
+    }
+};
+
+// times the rest of the enclosing block as one zone
+class ProfileScope
+{
+private:
+    Zone zone;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ProfileScope(Zone zoneIn) : zone(zoneIn), start(std::chrono::steady_clock::now()) {}
+    ~ProfileScope() { Profiler::add(zone, start, std::chrono::steady_clock::now()); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+// one more draw call this frame
+inline void countDraw(std::uint64_t calls = 1)
+{
+    Profiler::count(Counter::DrawCalls, calls);
+}
@@ -0,0 +1,266 @@
+#pragma once
+#include <SFML/Network.hpp>
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/Race.h"
+
+// seconds between batches, moves go up and progress comes down at most this often
+constexpr float NETWORK_TICK = 0.1f;
+// seconds the server and the players wait for everyone to join before giving up on the race
+constexpr float JOIN_TIMEOUT = 120.f;
+// messages the server lets pile up for a player who is not reading before it drops them, about five seconds
+constexpr std::size_t OUTBOX_LIMIT = 50;
+
+// race messages waiting to go out on a non blocking socket; a packet the socket took only part of
+// stays at the front and the packet itself remembers how far it got, so the next try carries on
+class Outbox
+{
+private:
+    std::deque<sf::Packet> packets;
+
+public:
+    void push(const std::vector<std::uint8_t>& bytes)
+    {
+        packets.emplace_back();
+        packets.back().append(bytes.data(), bytes.size());
+    }
+
+    // send as much as the socket takes without waiting, false once the connection is gone;
+    // a full send buffer only means trying again on the next tick
+    bool flush(sf::TcpSocket& socket)
+    {
+        while (!packets.empty())
+        {
+            const sf::Socket::Status status = socket.send(packets.front());
+            if (status == sf::Socket::Status::Done)
+                packets.pop_front();
+            else
+                return status == sf::Socket::Status::NotReady || status == sf::Socket::Status::Partial;
+        }
+        return true;
+    }
+
+    std::size_t size() const { return packets.size(); }
+};
+
+// runs the race server on its own thread: waits for every player to connect, sends each one the
+// start, then plays their moves as they come and sends everyone the progress once per network tick;
+// nothing on this thread waits on a player, so one who stops reading cannot hold up the others or stopping
+class RaceHost
+{
+private:
+    sf::TcpListener listener;   // listening before the thread starts, so the host's own player can join at once
+    bool listening = false;
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+
+    void run(RaceServer server)
+    {
+        sf::SocketSelector selector;
+        selector.add(listener);
+        std::vector<std::unique_ptr<sf::TcpSocket>> sockets;
+        sf::Clock waited;
+        while (static_cast<int>(sockets.size()) < server.size() && !stopping)
+        {
+            //players that never all turn up end the race before it starts
+            if (waited.getElapsedTime().asSeconds() > JOIN_TIMEOUT)
+            {
+                std::cerr << "the race gave up waiting for its players" << std::endl;
+                return;
+            }
+            if (!selector.wait(sf::seconds(NETWORK_TICK)) || !selector.isReady(listener))
+                continue;
+            auto socket = std::make_unique<sf::TcpSocket>();
+            if (listener.accept(*socket) != sf::Socket::Status::Done)
+                continue;
+            selector.add(*socket);
+            sockets.push_back(std::move(socket));
+        }
+        selector.remove(listener);
+        listener.close();
+
+        std::vector<std::uint8_t> bytes;
+        std::vector<bool> connected(sockets.size(), true);
+        std::vector<Outbox> outboxes(sockets.size());
+        auto drop = [&](std::size_t i)
+        {
+            selector.remove(*sockets[i]);
+            sockets[i]->disconnect();
+            connected[i] = false;
+        };
+        for (std::size_t i = 0; i < sockets.size(); i++)
+        {
+            sockets[i]->setBlocking(false);
+            server.start(static_cast<int>(i), bytes);
+            outboxes[i].push(bytes);
+            if (!outboxes[i].flush(*sockets[i]))
+                drop(i);
+        }
+        sf::Clock tick;
+        while (!stopping && std::find(connected.begin(), connected.end(), true) != connected.end())
+        {
+            const float left = std::max(0.001f, NETWORK_TICK - tick.getElapsedTime().asSeconds());
+            if (selector.wait(sf::seconds(left)))
+            {
+                for (std::size_t i = 0; i < sockets.size(); i++)
+                {
+                    if (!connected[i] || !selector.isReady(*sockets[i]))
+                        continue;
+                    sf::Packet packet;
+                    const sf::Socket::Status status = sockets[i]->receive(packet);
+                    if (status == sf::Socket::Status::NotReady || status == sf::Socket::Status::Partial)
+                        continue;   //the rest of the packet comes later
+                    //a player sending what is not a follow on batch of moves is dropped like one that left
+                    if (status != sf::Socket::Status::Done ||
+                        !server.receive(static_cast<int>(i), static_cast<const std::uint8_t*>(packet.getData()), packet.getDataSize()))
+                        drop(i);
+                }
+            }
+            if (tick.getElapsedTime().asSeconds() < NETWORK_TICK)
+                continue;
+            tick.restart();
+            const bool moved = server.progress(bytes);
+            for (std::size_t i = 0; i < sockets.size(); i++)
+            {
+                if (!connected[i])
+                    continue;
+                if (moved)
+                    outboxes[i].push(bytes);
+                //a player whose messages keep piling up has stopped reading, so let them go
+                if (!outboxes[i].flush(*sockets[i]) || outboxes[i].size() > OUTBOX_LIMIT)
+                    drop(i);
+            }
+        }
+    }
+
+public:
+    // races of players on the game's board, listening on port
+    RaceHost(unsigned short port, const ReplayHeader& game, int players)
+    {
+        listening = listener.listen(port) == sf::Socket::Status::Done;
+        if (listening)
+            worker = std::thread([this, game, players] { run(RaceServer(game, players)); });
+    }
+
+    ~RaceHost()
+    {
+        stopping = true;
+        if (worker.joinable())
+            worker.join();
+    }
+
+    RaceHost(const RaceHost&) = delete;
+    RaceHost& operator=(const RaceHost&) = delete;
+
+    bool ok() const { return listening; }
+};
+
+// how far joining a race has got
+enum class JoinState : std::uint8_t
+{
+    Waiting,    // connected, the server is waiting for the other players
+    Started,
+    Failed,     // the server went away, sent something else or the wait timed out
+};
+
+// one player's connection to the race server, polled by the board every frame; a player who hosts
+// the race also keeps the server here, so it lasts as long as their own part in the race
+class RaceLink
+{
+private:
+    std::unique_ptr<RaceHost> host; // first, so the server is stopped once this player's socket has closed
+    sf::TcpSocket socket;
+    RaceClient client;
+    Outbox outbox;                  // moves the socket has not taken yet
+    sf::Clock tick;                 // since moves were last sent
+    sf::Clock joined;               // since connecting, then for the bandwidth shown at the end
+    std::vector<std::uint8_t> bytes;
+    std::uint64_t sentBytes = 0;    // race messages both ways, with their 4 byte packet size
+    std::uint64_t receivedBytes = 0;
+    bool connected = false;
+
+public:
+    explicit RaceLink(std::unique_ptr<RaceHost> hostIn = nullptr) : host(std::move(hostIn)) {}
+
+    ~RaceLink()
+    {
+        if (!client.started())
+            return;
+        const double seconds = std::max(1.0, static_cast<double>(joined.getElapsedTime().asSeconds()));
+        std::cout << "race sent " << sentBytes << " bytes and received " << receivedBytes << " in " << seconds << " s ("
+                  << static_cast<double>(sentBytes + receivedBytes) / seconds << " bytes a second)" << std::endl;
+    }
+
+    // connect to the server, the race starts later once every player has joined (see poll)
+    bool connect(const std::string& address, unsigned short port)
+    {
+        const std::optional<sf::IpAddress> ip = sf::IpAddress::resolve(address);
+        if (!ip || socket.connect(*ip, port, sf::seconds(10.f)) != sf::Socket::Status::Done)
+            return false;
+        socket.setBlocking(false);
+        joined.restart();
+        return true;
+    }
+
+    // check without waiting whether the server has started the race, called every frame until it has
+    JoinState poll()
+    {
+        if (client.started())
+            return JoinState::Started;
+        sf::Packet packet;
+        const sf::Socket::Status status = socket.receive(packet);
+        if (status == sf::Socket::Status::NotReady || status == sf::Socket::Status::Partial)
+            return joined.getElapsedTime().asSeconds() > JOIN_TIMEOUT ? JoinState::Failed : JoinState::Waiting;
+        if (status != sf::Socket::Status::Done ||
+            !client.start(static_cast<const std::uint8_t*>(packet.getData()), packet.getDataSize()))
+            return JoinState::Failed;
+        receivedBytes += packet.getDataSize() + 4;
+        connected = true;
+        joined.restart();
+        return JoinState::Started;
+    }
+
+    RaceClient& race() { return client; }
+    const RaceClient& race() const { return client; }
+    bool online() const { return connected; }
+
+    // take in any progress and send the moves made once a network tick; true when progress came in.
+    // Only a closed or broken connection ends the link, moves the socket is not ready for wait their turn
+    bool update()
+    {
+        if (!connected)
+            return false;
+        bool heard = false;
+        sf::Packet packet;
+        sf::Socket::Status status;
+        while ((status = socket.receive(packet)) == sf::Socket::Status::Done)
+        {
+            receivedBytes += packet.getDataSize() + 4;
+            heard = client.receive(static_cast<const std::uint8_t*>(packet.getData()), packet.getDataSize()) || heard;
+            packet.clear();
+        }
+        if (status == sf::Socket::Status::Disconnected || status == sf::Socket::Status::Error)
+            connected = false;
+        if (connected && tick.getElapsedTime().asSeconds() >= NETWORK_TICK)
+        {
+            tick.restart();
+            if (client.batch(bytes))
+            {
+                sentBytes += bytes.size() + 4;
+                outbox.push(bytes);
+            }
+        }
+        if (connected)
+            connected = outbox.flush(socket);
+        return heard;
+    }
+};
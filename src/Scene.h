@@ -0,0 +1,121 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <utility>
+#include "Profiler.h"
+
+class SceneManager;
+
+// one screen of the game (title, difficulty select, a board), all scenes share the one window
+class Scene
+{
+public:
+    virtual ~Scene() = default;
+    // react to one window event, a scene moves on by asking the manager for the next scene
+    virtual void handle(const sf::Event& event, SceneManager& scenes) = 0;
+    // advance anything animated
+    virtual void update(float secsSinceLastFrame) { (void)secsSinceLastFrame; }
+    // draw the whole frame, the manager displays it
+    virtual void draw(sf::RenderWindow& window) = 0;
+    // true while something moves without input (effects, a spreading flood), the manager then draws
+    // every frame; otherwise it sleeps until the next event and only draws again after it
+    virtual bool animating() const { return false; }
+};
+
+// owns the long lived window and the scene on it, a new scene takes over at the end of the frame
+// so the scene asking for the change is never destroyed while it is still handling an event;
+// frames are paced by the frame limit while the scene animates and by input while it is still
+class SceneManager
+{
+private:
+    static constexpr float IDLE_WAIT = 1.f;    // seconds an idle loop sleeps before checking it should still run
+
+    sf::RenderWindow& window;           // the only window the game opens
+    std::unique_ptr<Scene> current;     // scene being shown
+    std::unique_ptr<Scene> pending;     // scene that takes over after this frame
+    bool running = true;                // false once the game should end
+
+public:
+    explicit SceneManager(sf::RenderWindow& windowIn) : window(windowIn) {}
+
+    // switch to a new scene once the current frame is done
+    template <class T, class... Args>
+    void change(Args&&... args)
+    {
+        pending = std::make_unique<T>(std::forward<Args>(args)...);
+    }
+
+    // end the game after this frame
+    void quit() { running = false; }
+
+    sf::RenderWindow& getWindow() { return window; }
+
+    // run scenes until one quits or the window is closed
+    void run()
+    {
+        sf::Clock clk;  //SFML stopwatch
+        bool idle = false;  //the last frame drawn had nothing moving, so nothing changes until an event
+        while (running && window.isOpen())
+        {
+            if (pending)
+            {
+                current = std::move(pending);
+                idle = false;
+            }
+            if (!current)
+                break;
+            //an idle screen sleeps in the window's event wait instead of drawing the same frame again
+            std::optional<sf::Event> woken;
+            if (idle)
+            {
+                woken = window.waitEvent(sf::seconds(IDLE_WAIT));
+                if (!woken)
+                    continue;
+                clk.restart();  //time spent asleep is not animation time
+            }
+            float secsSinceLastFrame = clk.restart().asSeconds();
+            Profiler::beginFrame();
+            //events after a change are left in the queue for the next scene
+            while (!pending)
+            {
+                std::optional<sf::Event> event = std::move(woken);
+                woken.reset();
+                if (!event)
+                {
+                    ProfileScope timer(Zone::Events);
+                    event = window.pollEvent();
+                }
+                if (!event)
+                    break;
+                ProfileScope timer(Zone::Input);
+                //ends program if the user closes the window
+                if (event->is<sf :: Event :: Closed>())
+                    quit();
+                //F3 shows the frame profiler on every scene
+                else if (event->is<sf::Event::KeyPressed>() && event->getIf<sf::Event::KeyPressed>()->scancode == sf::Keyboard::Scancode::F3)
+                    Profiler::toggleOverlay();
+                else
+                    current->handle(*event, *this);
+            }
+            if (pending)
+            {
+                Profiler::endFrame();
+                continue;
+            }
+            {
+                ProfileScope timer(Zone::Update);
+                current->update(secsSinceLastFrame);
+            }
+            current->draw(window);
+            Profiler::drawOverlay(window);
+            {
+                ProfileScope timer(Zone::Display);
+                window.display();
+            }
+            Profiler::endFrame();
+            //the overlay's numbers only mean something while frames keep coming
+            idle = !current->animating() && !Profiler::overlayShown();
+        }
+        window.close();
+    }
+};
@@ -5,110 +5,96 @@
 #define TITLE_H
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
+#include <string>
 #include "Demolition.h"
 #include "Difficulty.h"
 #include "Effects.h"
+#include "HitTest.h"
+#include "Scene.h"
 
-inline void title()
+// title screen with play, demolition and exit buttons
+class TitleScene : public Scene
 {
-    sf :: RenderWindow title;
-    title.create(sf :: VideoMode({1920,1080}), "MINESWEEPER", sf :: State :: Fullscreen);
-    title.setFramerateLimit(60);
-    //initialize screen object
-    bool mouseHoverPlay=false,mouseHoverDemolition=false,mouseHoverExit=false;
-    while (title.isOpen())
+private:
+    //picture shown, it changes to highlight the button under the mouse
+    std::string screen = "Minesweeper_title_screen_new.png";
+
+public:
+    TitleScene()
+    {
+        for (const char* name : {"Minesweeper_title_screen_new.png", "Minesweeper_title_screen_new_play.png",
+                                 "Minesweeper_title_screen_new_demolition.png", "Minesweeper_title_screen_new_exit.png"})
+            Assets::prefetch(name);
+    }
+
+    void handle(const sf::Event& event, SceneManager& scenes) override
     {
-        // check all the window's events that were triggered since the last iteration of the loop
-        while (const std :: optional event = title.pollEvent())
+        //closes the game when the ESC key is pressed
+        if (const auto* keyPressed = event.getIf<sf :: Event :: KeyPressed>())
         {
-            // "close requested" event: we close the window
-            if (event->is<sf :: Event :: Closed>())
-                title.close();
-            //closes the window when the ESC key is pressed
-            else if (const auto* keyPressed = event->getIf<sf :: Event :: KeyPressed>())
+            if (keyPressed->scancode == sf :: Keyboard :: Scancode :: Escape)
+                scenes.quit();
+        }
+        //sets up invisible buttons that the user can click for the desired action
+        else if (const auto* mouseButtonReleased = event.getIf<sf::Event::MouseButtonReleased>())
+        {
+            //where the click happened, taken from the event itself
+            const sf::Vector2i click = mouseButtonReleased->position;
+            if (mouseButtonReleased->button == sf::Mouse::Button::Left)
             {
-                if (keyPressed->scancode == sf :: Keyboard :: Scancode :: Escape)
-                    title.close();
+                //difficulty screen opens
+                if (PLAY_BUTTON.contains(click))
+                    difficulty(scenes);
+                //demolition board opens
+                else if (DEMOLITION_BUTTON.contains(click))
+                    Demolition(scenes);
+                else if (EXIT_BUTTON.contains(click))
+                    scenes.quit();
             }
-            //sets up invisible buttons that the user can click for the desired action
-            else if (const auto* mouseButtonReleased = event->getIf<sf::Event::MouseButtonReleased>())
+        }
+        //finds position of mouse whenever it is moved in order to highlight buttons,
+        //the button stays highlighted until the mouse is moved off of it
+        else if (const auto* mouseMoved = event.getIf<sf::Event::MouseMoved>())
+        {
+            sf::Vector2i localPosition = mouseMoved->position;
+            //the screen behind a button the mouse is over is likely next, so it starts loading now
+            if (PLAY_BUTTON.contains(localPosition))
             {
-                if (mouseButtonReleased->button == sf::Mouse::Button::Left)
-                {
-                    if (sf::Mouse::getPosition(title).x >=751 && sf::Mouse::getPosition(title).x <=1175 && sf::Mouse::getPosition(title).y >=680 && sf::Mouse::getPosition(title).y <=780)
-                    {
-                        title.close();
-                        //difficulty window opens
-                        difficulty();
-                    }
-                    else if (sf::Mouse::getPosition(title).x >=751 && sf::Mouse::getPosition(title).x <=1175 && sf::Mouse::getPosition(title).y >=817 && sf::Mouse::getPosition(title).y <=910)
-                    {
-                        title.close();
-                        //demolition window opens
-                        Demolition();
-                    }
-                    else if (sf::Mouse::getPosition(title).x >=751 && sf::Mouse::getPosition(title).x <=1175 && sf::Mouse::getPosition(title).y >=953 && sf::Mouse::getPosition(title).y <=1044)
-                    {
-                        title.close();
-                    }
-                }
+                screen = "Minesweeper_title_screen_new_play.png";
+                Assets::prefetch("Minesweeper_difficulty_select.png");
             }
-            //finds position of mouse whenever it is moved in order to highlight buttons
-            else if (const auto* mouseMoved = event->getIf<sf::Event::MouseMoved>())
+            else if (DEMOLITION_BUTTON.contains(localPosition))
             {
-                sf::Vector2i localPosition = sf::Mouse::getPosition(title);
-                if ((localPosition.x >=751 && localPosition.x <=1175) && (localPosition.y >= 680 && localPosition.y <=780))
-                {
-                    loadScreen(title, "../../src/imagesAudio/Minesweeper_title_screen_new_play.png");
-                    title.display();
-                    mouseHoverPlay = true;
-                }
-                else if ((localPosition.x >= 752 && localPosition.x <= 1178) && (localPosition.y >= 817 && localPosition.y <= 910))
-                {
-                    loadScreen(title, "../../src/imagesAudio/Minesweeper_title_screen_new_demolition.png");
-                    title.display();
-                    mouseHoverDemolition = true;
-                }
-                else if ((localPosition.x >= 753 && localPosition.x <= 1177) && (localPosition.y >= 953 && localPosition.y <= 1044))
-                {
-                    loadScreen(title, "../../src/imagesAudio/Minesweeper_title_screen_new_exit.png");
-                    title.display();
-                    mouseHoverExit = true;
-                }
-                else
-                {
-                    loadScreen(title, "../../src/imagesAudio/Minesweeper_title_screen_new.png");
-                    title.display();
-                    mouseHoverPlay=false,mouseHoverDemolition=false,mouseHoverExit=false;
-                }
+                screen = "Minesweeper_title_screen_new_demolition.png";
+                prefetchBoard(demolitionBoard());
             }
+            else if (EXIT_BUTTON.contains(localPosition))
+                screen = "Minesweeper_title_screen_new_exit.png";
+            else
+                screen = "Minesweeper_title_screen_new.png";
         }
-        //series of if statements that keep button highlighted until the mouse is moved off of the button
-        if (mouseHoverPlay==true && mouseHoverDemolition==false && mouseHoverExit==false)
-        {
-            loadScreen(title, "../../src/imagesAudio/Minesweeper_title_screen_new_play.png");
-            title.display();
-        }
-
-
-        else if (mouseHoverDemolition==true && mouseHoverExit==false && mouseHoverPlay==false)
-        {
-            loadScreen(title, "../../src/imagesAudio/Minesweeper_title_screen_new_demolition.png");
-            title.display();
-        }
+    }
 
+    // prefetched images become textures a little each frame, so keep drawing until they are in
+    void update(float secsSinceLastFrame) override
+    {
+        (void)secsSinceLastFrame;
+        Assets::upload(sf::seconds(UPLOAD_BUDGET));
+    }
 
-        else if (mouseHoverExit==true && mouseHoverPlay==false && mouseHoverDemolition==false)
-        {
-            loadScreen(title, "../../src/imagesAudio/Minesweeper_title_screen_new_exit.png");
-            title.display();
-        }
+    bool animating() const override
+    {
+        return Assets::loading() > 0;
+    }
 
-        else
-        {
-            loadScreen(title, "../../src/imagesAudio/Minesweeper_title_screen_new.png");
-            title.display();
-        }
+    void draw(sf::RenderWindow& window) override
+    {
+        loadScreen(window, screen);
     }
+};
+
+inline void title(SceneManager& scenes)
+{
+    scenes.change<TitleScene>();
 }
-#endif //TITLE_H
\ No newline at end of file
+#endif //TITLE_H
@@ -0,0 +1,183 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// layout of an asset archive as written by tools/pack_assets.cpp, all numbers little endian:
+//   header   "MSPAK001", u32 file count
+//   index    per file: u16 name length, name, u64 offset from the start of the archive, u64 size
+//   data     every file's bytes, each starting on an ARCHIVE_ALIGN boundary
+constexpr char ARCHIVE_MAGIC[8] = {'M', 'S', 'P', 'A', 'K', '0', '0', '1'};
+constexpr std::size_t ARCHIVE_ALIGN = 16;
+
+// a whole file mapped read only into memory, the operating system pages it in as it is read
+class MappedFile
+{
+private:
+    const unsigned char* bytes = nullptr;
+    std::size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    void close()
+    {
+#ifdef _WIN32
+        if (bytes)
+            UnmapViewOfFile(bytes);
+        if (mapping)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+        mapping = nullptr;
+#else
+        if (bytes)
+            munmap(const_cast<unsigned char*>(bytes), length);
+#endif
+        bytes = nullptr;
+        length = 0;
+    }
+
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // map path, false when it cannot be opened or is empty
+    bool open(const std::string& path)
+    {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            close();
+            return false;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping)
+            bytes = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!bytes)
+        {
+            close();
+            return false;
+        }
+        length = static_cast<std::size_t>(size.QuadPart);
+#else
+        const int descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0)
+            return false;
+        struct stat info;
+        if (fstat(descriptor, &info) != 0 || info.st_size == 0)
+        {
+            ::close(descriptor);
+            return false;
+        }
+        void* mapped = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+        ::close(descriptor);    //the mapping keeps the file open
+        if (mapped == MAP_FAILED)
+            return false;
+        bytes = static_cast<const unsigned char*>(mapped);
+        length = static_cast<std::size_t>(info.st_size);
+#endif
+        return true;
+    }
+
+    const unsigned char* data() const { return bytes; }
+    std::size_t size() const { return length; }
+};
+
+// one file inside the archive, pointing straight into the mapping
+struct ArchiveEntry
+{
+    const unsigned char* data = nullptr;
+    std::size_t size = 0;
+};
+
+// files packed into one mapped archive, found by name without copying them
+class AssetArchive
+{
+private:
+    MappedFile file;
+    std::unordered_map<std::string_view, ArchiveEntry> entries;   // names point into the mapping
+
+    template <class T>
+    static T readLittle(const unsigned char* at)
+    {
+        T value = 0;
+        for (std::size_t i = 0; i < sizeof(T); i++)
+            value |= static_cast<T>(at[i]) << (8 * i);
+        return value;
+    }
+
+public:
+    // map the archive at path and read its index, false leaves it empty when the file is missing or malformed
+    bool open(const std::string& path)
+    {
+        entries.clear();
+        if (!file.open(path))
+            return false;
+        const unsigned char* bytes = file.data();
+        const std::size_t size = file.size();
+        if (size < sizeof(ARCHIVE_MAGIC) + 4 || std::memcmp(bytes, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0)
+            return false;
+        const std::uint32_t count = readLittle<std::uint32_t>(bytes + sizeof(ARCHIVE_MAGIC));
+        std::size_t at = sizeof(ARCHIVE_MAGIC) + 4;
+        for (std::uint32_t i = 0; i < count; i++)
+        {
+            //every read is checked against the end so a cut off archive is rejected rather than read past
+            if (at + 2 > size)
+                break;
+            const std::uint16_t nameLength = readLittle<std::uint16_t>(bytes + at);
+            at += 2;
+            if (at + nameLength + 16 > size)
+                break;
+            const std::string_view name(reinterpret_cast<const char*>(bytes + at), nameLength);
+            at += nameLength;
+            const std::uint64_t offset = readLittle<std::uint64_t>(bytes + at);
+            const std::uint64_t length = readLittle<std::uint64_t>(bytes + at + 8);
+            at += 16;
+            if (offset > size || length > size - offset)
+                break;
+            entries[name] = {bytes + offset, static_cast<std::size_t>(length)};
+        }
+        if (entries.size() != count)
+        {
+            entries.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // the bytes of a packed file, or nullptr data when it is not in the archive
+    ArchiveEntry find(std::string_view name) const
+    {
+        auto found = entries.find(name);
+        return found == entries.end() ? ArchiveEntry{} : found->second;
+    }
+
+    bool empty() const { return entries.empty(); }
+};
@@ -0,0 +1,237 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// a square on the board
+struct Cell
+{
+    int rows;
+    int columns;
+};
+
+// steps to the eight squares around a square, walked as a fixed table so the loops over it unroll
+inline constexpr std::array<Cell, 8> NEIGHBOURS = {{{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}}};
+
+// number of set bits in a word
+inline int popcount64(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(word));
+#else
+    //add bits in pairs, then nibbles, then bytes
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// index of the lowest set bit of a word that is not zero
+inline int lowestBit64(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return popcount64((word & (~word + 1)) - 1);   //the bits below the lowest one
+#endif
+}
+
+// one bit per square, each row of squares is packed into 64 bit words
+class BitPlane
+{
+private:
+    int rowCount;                       // rows in the plane
+    int columnCount;                    // squares in each row
+    int wordsPerRow;                    // words holding one row
+    std::vector<std::uint64_t> words;   // all rows back to back
+
+public:
+    BitPlane(int rowsIn, int columnsIn)
+        : rowCount(rowsIn), columnCount(columnsIn), wordsPerRow((columnsIn + 63) / 64),
+          words(static_cast<std::size_t>(rowsIn) * ((columnsIn + 63) / 64), 0)
+    {
+    }
+
+    int rows() const { return rowCount; }
+    int columns() const { return columnCount; }
+    int rowWords() const { return wordsPerRow; }
+
+    // words of one row, bits past the last column are always zero
+    std::uint64_t* row(int rows) { return &words[static_cast<std::size_t>(rows) * wordsPerRow]; }
+    const std::uint64_t* row(int rows) const { return &words[static_cast<std::size_t>(rows) * wordsPerRow]; }
+
+    bool test(int rows, int columns) const
+    {
+        return (row(rows)[columns >> 6] >> (columns & 63)) & 1;
+    }
+
+    void set(int rows, int columns)
+    {
+        row(rows)[columns >> 6] |= std::uint64_t(1) << (columns & 63);
+    }
+
+    void reset(int rows, int columns)
+    {
+        row(rows)[columns >> 6] &= ~(std::uint64_t(1) << (columns & 63));
+    }
+
+    // clear every square
+    void clear()
+    {
+        for (std::uint64_t& word : words)
+            word = 0;
+    }
+
+    // how many squares are set
+    int count() const
+    {
+        int total = 0;
+        for (std::uint64_t word : words)
+            total += popcount64(word);
+        return total;
+    }
+
+    // how many squares are set here but not in other
+    int countAndNot(const BitPlane& other) const
+    {
+        int total = 0;
+        for (std::size_t i = 0; i < words.size(); i++)
+            total += popcount64(words[i] & ~other.words[i]);
+        return total;
+    }
+
+    // true if any square is set in both planes
+    bool intersects(const BitPlane& other) const
+    {
+        for (std::size_t i = 0; i < words.size(); i++)
+            if (words[i] & other.words[i])
+                return true;
+        return false;
+    }
+
+    // same squares set, the planes have to be the same size
+    bool operator==(const BitPlane& other) const { return words == other.words; }
+    bool operator!=(const BitPlane& other) const { return words != other.words; }
+};
+
+// calls visit(rows, word, mask) for each word covering the eight neighbours of a square,
+// the mask holds the neighbour bits inside that word and never the square itself
+template <class Visit>
+void forNeighbours(const BitPlane& plane, int rows, int columns, Visit visit)
+{
+    int first = columns > 0 ? columns - 1 : 0;
+    int last = columns + 1 < plane.columns() ? columns + 1 : plane.columns() - 1;
+    for (int checkRow = rows - 1; checkRow <= rows + 1; checkRow++)
+    {
+        if (checkRow < 0 || checkRow >= plane.rows())
+            continue;
+        for (int word = first >> 6; word <= last >> 6; word++)
+        {
+            int low = (first > word * 64 ? first : word * 64) - word * 64;
+            int high = (last < word * 64 + 63 ? last : word * 64 + 63) - word * 64;
+            std::uint64_t mask = (~std::uint64_t(0) >> (63 - high)) & (~std::uint64_t(0) << low);
+            if (checkRow == rows && (columns >> 6) == word)
+                mask &= ~(std::uint64_t(1) << (columns & 63)); //skip where you are
+            if (mask)
+                visit(checkRow, word, mask);
+        }
+    }
+}
+
+// neighbour bits of a row word: bit i of the result is bit i-1 (west) or i+1 (east) of the row
+inline std::uint64_t westOf(const std::uint64_t* row, int word)
+{
+    return (row[word] << 1) | (word > 0 ? row[word - 1] >> 63 : 0);
+}
+
+inline std::uint64_t eastOf(const std::uint64_t* row, int word, int words)
+{
+    return (row[word] >> 1) | (word + 1 < words ? row[word + 1] << 63 : 0);
+}
+
+// how many mines touch each square, one byte per square
+class MineCounts
+{
+private:
+    int rowCount;                       // rows on the board
+    int columnCount;                    // squares per row
+    std::vector<std::uint8_t> counts;   // rows back to back
+
+public:
+    MineCounts(int rowsIn, int columnsIn)
+        : rowCount(rowsIn), columnCount(columnsIn), counts(static_cast<std::size_t>(rowsIn) * columnsIn, 0)
+    {
+    }
+
+    int at(int rows, int columns) const
+    {
+        return counts[static_cast<std::size_t>(rows) * columnCount + columns];
+    }
+
+    // count every square at once: the eight neighbour planes of a row are shifted into place
+    // and summed 64 squares at a time with a bit sliced counter
+    void build(const BitPlane& mines)
+    {
+        const int words = mines.rowWords();
+        for (int rows = 0; rows < mines.rows(); rows++)
+        {
+            const std::uint64_t* above = rows > 0 ? mines.row(rows - 1) : nullptr;
+            const std::uint64_t* here = mines.row(rows);
+            const std::uint64_t* below = rows + 1 < mines.rows() ? mines.row(rows + 1) : nullptr;
+            for (int word = 0; word < words; word++)
+            {
+                std::uint64_t neighbours[8] = {
+                    above ? westOf(above, word) : 0, above ? above[word] : 0, above ? eastOf(above, word, words) : 0,
+                    westOf(here, word), eastOf(here, word, words),
+                    below ? westOf(below, word) : 0, below ? below[word] : 0, below ? eastOf(below, word, words) : 0
+                };
+                //four bit counter per square, bit0 is the ones place
+                std::uint64_t bit0 = 0, bit1 = 0, bit2 = 0, bit3 = 0;
+                for (std::uint64_t add : neighbours)
+                {
+                    std::uint64_t carry0 = bit0 & add;
+                    bit0 ^= add;
+                    std::uint64_t carry1 = bit1 & carry0;
+                    bit1 ^= carry0;
+                    std::uint64_t carry2 = bit2 & carry1;
+                    bit2 ^= carry1;
+                    bit3 |= carry2;
+                }
+                //spread the counter bits back out to one byte per square
+                int end = columnCount - word * 64 < 64 ? columnCount - word * 64 : 64;
+                std::uint8_t* out = &counts[static_cast<std::size_t>(rows) * columnCount + word * 64];
+                for (int i = 0; i < end; i++)
+                {
+                    out[i] = static_cast<std::uint8_t>(((bit0 >> i) & 1) | (((bit1 >> i) & 1) << 1) |
+                                                       (((bit2 >> i) & 1) << 2) | (((bit3 >> i) & 1) << 3));
+                }
+            }
+        }
+    }
+
+    // add (change=1) or remove (change=-1) a mine at a square from its neighbours' counts
+    void update(int rows, int columns, int change)
+    {
+        for (const Cell& step : NEIGHBOURS)
+        {
+            const int checkRow = rows + step.rows;
+            const int checkColumn = columns + step.columns;
+            if (checkRow >= 0 && checkRow < rowCount && checkColumn >= 0 && checkColumn < columnCount)
+            {
+                std::uint8_t& count = counts[static_cast<std::size_t>(checkRow) * columnCount + checkColumn];
+                count = static_cast<std::uint8_t>(count + change);
+            }
+        }
+    }
+};
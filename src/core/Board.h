@@ -0,0 +1,168 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "BitBoard.h"
+#include "Flood.h"
+#include "Mines.h"
+
+// rules a board is played with
+enum class GameMode
+{
+    Classic,    // find every safe square, one mine ends the game
+    Demolition  // find every mine, every safe square opened after the first click costs a life
+};
+
+// what one left click did, the screen turns this into tiles, sounds and effects
+struct ClickResult
+{
+    std::vector<Cell> changed;  // squares whose tile may have changed
+    bool accepted = false;      // false if the click did nothing
+    bool hitMine = false;       // a mine was opened
+    bool lostLife = false;      // demolition only, a safe square cost a life
+    bool ended = false;         // this click ended the game, every tile needs picking again
+};
+
+// one game of minesweeper of any size, all state lives in bit planes sized at runtime
+class Board
+{
+private:
+    int rowCount;               // squares across, the x index as on screen
+    int columnCount;            // squares down, the y index
+    int mineTotal;              // mines on the board
+    GameMode mode;              // rules in play
+    BitPlane grid;              // where the mines are
+    BitPlane selected;          // squares that have been opened
+    BitPlane flagged;           // squares with a flag on them
+    MineCounts mineCounts;      // mines touching each square
+    FloodFill flood;            // opens empty areas
+    int gameOver = 0;           // 0 playing, 1 lost, 2 won
+    int revealedSafe = 0;       // safe squares opened so far
+    int revealedMines = 0;      // mines opened so far
+    int points = 0;             // score
+    int startLives;             // demolition lives at the start of a game
+    int livesLeft;              // demolition lives left
+    int clicks = 0;             // left clicks that opened something
+    ClickResult result;         // reused by every click
+
+    void addOpened(const RevealResult& opened)
+    {
+        revealedMines += opened.mines;
+        revealedSafe += static_cast<int>(opened.cells.size()) - opened.mines;
+        points += opened.score;
+        result.changed.insert(result.changed.end(), opened.cells.begin(), opened.cells.end());
+    }
+
+    void classicClick(int rows, int columns)
+    {
+        //select the square, an empty square floods open its whole area and every safe square opened is worth 100 points
+        addOpened(flood.reveal(grid, mineCounts, selected, rows, columns, 100));
+        result.hitMine = grid.test(rows, columns);
+        //if the user has selected a mine the game ends, so does opening the last safe square
+        if (revealedMines > 0)
+            gameOver = 1;
+        else if (revealedSafe == rowCount * columnCount - mineTotal)
+            gameOver = 2;
+    }
+
+    void demolitionClick(int rows, int columns)
+    {
+        //every safe square after the first click of the game takes away a life
+        if (clicks != 0 && !grid.test(rows, columns) && !selected.test(rows, columns))
+        {
+            livesLeft -= 1;
+            result.lostLife = true;
+        }
+        const RevealResult& opened = flood.reveal(grid, mineCounts, selected, rows, columns, 0);
+        bool foundMine = opened.mines > 0;
+        addOpened(opened);
+        if (foundMine)
+        {
+            //a found mine is worth 500 points and gives the player more info around it
+            points += 500;
+            addOpened(flood.revealAround(grid, mineCounts, selected, rows, columns));
+        }
+        //out of lives ends the game, finding every mine wins
+        if (livesLeft <= 0)
+            gameOver = 1;
+        else if (revealedMines == mineTotal)
+            gameOver = 2;
+    }
+
+public:
+    Board(int rowsIn, int columnsIn, int minesIn, GameMode modeIn, int livesIn = 5)
+        : rowCount(rowsIn), columnCount(columnsIn), mineTotal(minesIn), mode(modeIn),
+          grid(rowsIn, columnsIn), selected(rowsIn, columnsIn), flagged(rowsIn, columnsIn),
+          mineCounts(rowsIn, columnsIn), flood(rowsIn * columnsIn), startLives(livesIn), livesLeft(livesIn)
+    {
+        if (mineTotal > rowCount * columnCount)
+            mineTotal = rowCount * columnCount;
+        result.changed.reserve(static_cast<std::size_t>(rowsIn) * columnsIn);
+    }
+
+    // lay the mines out from a seed on a fresh board, the same seed always gives the same board;
+    // everything is cleared in place so one Board can play any number of games without allocating
+    void generate(std::uint64_t seed)
+    {
+        grid.clear();
+        selected.clear();
+        flagged.clear();
+        gameOver = 0;
+        revealedSafe = 0;
+        revealedMines = 0;
+        points = 0;
+        livesLeft = startLives;
+        clicks = 0;
+        placeMines(grid, mineTotal, seed);
+        mineCounts.build(grid);
+    }
+
+    int rows() const { return rowCount; }
+    // true once the game has been won or lost
+    bool finished() const { return gameOver != 0; }
+    int columns() const { return columnCount; }
+    int mines() const { return mineTotal; }
+    GameMode rules() const { return mode; }
+    int state() const { return gameOver; }
+    int score() const { return points; }
+    int lives() const { return livesLeft; }
+
+    bool isMine(int rows, int columns) const { return grid.test(rows, columns); }
+    bool isOpen(int rows, int columns) const { return selected.test(rows, columns); }
+    bool isFlagged(int rows, int columns) const { return flagged.test(rows, columns); }
+    int mineCount(int rows, int columns) const { return mineCounts.at(rows, columns); }
+
+    const BitPlane& minePlane() const { return grid; }
+    const BitPlane& openPlane() const { return selected; }
+    const BitPlane& flagPlane() const { return flagged; }
+    const MineCounts& counts() const { return mineCounts; }
+
+    // place a flag, or remove it if the square is already flagged, only classic boards take flags
+    bool toggleFlag(int rows, int columns)
+    {
+        if (gameOver != 0 || mode != GameMode::Classic || selected.test(rows, columns))
+            return false;
+        if (flagged.test(rows, columns))
+            flagged.reset(rows, columns);
+        else
+            flagged.set(rows, columns);
+        return true;
+    }
+
+    // left click on a square, played by the rules of the board's mode
+    const ClickResult& open(int rows, int columns)
+    {
+        //reset in place so the changed list keeps its capacity
+        result.changed.clear();
+        result.accepted = result.hitMine = result.lostLife = result.ended = false;
+        if (gameOver != 0 || flagged.test(rows, columns))
+            return result;
+        result.accepted = true;
+        if (mode == GameMode::Classic)
+            classicClick(rows, columns);
+        else
+            demolitionClick(rows, columns);
+        clicks++;
+        result.ended = gameOver != 0;
+        return result;
+    }
+};
@@ -0,0 +1,240 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "BitBoard.h"
+#include "Board.h"
+
+// squares along each side of a chunk of the endless board
+constexpr int CHUNK_SIZE = 32;
+
+// round down when dividing, so square -1 is in chunk -1 and not chunk 0
+inline int floorDiv(int value, int by)
+{
+    return value >= 0 ? value / by : -((-value + by - 1) / by);
+}
+
+// one 32 by 32 piece of the endless board, made the first time anything looks at it
+struct Chunk
+{
+    BitPlane mines{CHUNK_SIZE, CHUNK_SIZE};     // where the mines are
+    BitPlane opened{CHUNK_SIZE, CHUNK_SIZE};    // squares that have been opened
+    BitPlane flagged{CHUNK_SIZE, CHUNK_SIZE};   // squares with a flag on them
+    std::uint8_t counts[CHUNK_SIZE * CHUNK_SIZE] = {}; // mines touching each square, including ones in the next chunk
+    bool touched = false;                       // something was opened or flagged, so it must be kept
+
+    int count(int rows, int columns) const { return counts[rows * CHUNK_SIZE + columns]; }
+};
+
+// a board with no edges, only chunks that have been looked at or played are kept in memory;
+// a mine depends only on the seed and where it is, so a chunk that was thrown away comes back the same
+class ChunkedBoard
+{
+private:
+    std::uint64_t seed;                             // picks the whole board
+    std::uint64_t threshold;                        // a square is a mine if its hash is below this
+    std::unordered_map<std::uint64_t, Chunk> chunks; // chunks in memory by packed coordinate
+    std::vector<Cell> frontier;                     // empty squares whose neighbours still need opening
+    std::size_t next = 0;                           // front of the frontier
+    std::vector<Cell> opened;                       // squares opened by the last open or spread
+    int gameOver = 0;                               // 0 playing, 1 lost
+    int points = 0;                                 // 100 per safe square
+    ClickResult result;                             // reused by every click
+
+    static std::uint64_t key(int chunkRow, int chunkColumn)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunkRow)) << 32) | static_cast<std::uint32_t>(chunkColumn);
+    }
+
+    // chunk holding a square and where the square sits inside it
+    Chunk& chunkFor(int rows, int columns, int& localRow, int& localColumn)
+    {
+        int chunkRow = floorDiv(rows, CHUNK_SIZE);
+        int chunkColumn = floorDiv(columns, CHUNK_SIZE);
+        localRow = rows - chunkRow * CHUNK_SIZE;
+        localColumn = columns - chunkColumn * CHUNK_SIZE;
+        return chunk(chunkRow, chunkColumn);
+    }
+
+    // select a safe square, empty squares join the frontier so the flood can carry on later
+    void openSafe(Chunk& chunk, int localRow, int localColumn, int rows, int columns)
+    {
+        chunk.opened.set(localRow, localColumn);
+        chunk.touched = true;
+        opened.push_back({rows, columns});
+        points += 100;
+        if (chunk.count(localRow, localColumn) == 0)
+            frontier.push_back({rows, columns});
+    }
+
+public:
+    // density is the chance of any one square being a mine
+    ChunkedBoard(std::uint64_t seedIn, double density)
+        : seed(seedIn), threshold(static_cast<std::uint64_t>(density * 18446744073709551616.0))
+    {
+    }
+
+    // true if a square holds a mine, worked out from the seed without making its chunk;
+    // the squares around the start are always safe so the first click never loses
+    bool mineAt(int rows, int columns) const
+    {
+        if (rows >= -1 && rows <= 1 && columns >= -1 && columns <= 1)
+            return false;
+        std::uint64_t square = key(rows, columns);
+        return mixBits(seed ^ mixBits(square)) < threshold;
+    }
+
+    // get a chunk, making it from the seed the first time
+    Chunk& chunk(int chunkRow, int chunkColumn)
+    {
+        auto found = chunks.find(key(chunkRow, chunkColumn));
+        if (found != chunks.end())
+            return found->second;
+        Chunk& made = chunks[key(chunkRow, chunkColumn)];
+        //the counts need the ring of squares around the chunk too, so work out a padded plane
+        BitPlane padded(CHUNK_SIZE + 2, CHUNK_SIZE + 2);
+        int firstRow = chunkRow * CHUNK_SIZE - 1;
+        int firstColumn = chunkColumn * CHUNK_SIZE - 1;
+        for (int r = 0; r < CHUNK_SIZE + 2; r++)
+        {
+            for (int c = 0; c < CHUNK_SIZE + 2; c++)
+            {
+                if (mineAt(firstRow + r, firstColumn + c))
+                    padded.set(r, c);
+            }
+        }
+        MineCounts paddedCounts(CHUNK_SIZE + 2, CHUNK_SIZE + 2);
+        paddedCounts.build(padded);
+        for (int r = 0; r < CHUNK_SIZE; r++)
+        {
+            for (int c = 0; c < CHUNK_SIZE; c++)
+            {
+                if (padded.test(r + 1, c + 1))
+                    made.mines.set(r, c);
+                made.counts[r * CHUNK_SIZE + c] = static_cast<std::uint8_t>(paddedCounts.at(r + 1, c + 1));
+            }
+        }
+        return made;
+    }
+
+    bool isMine(int rows, int columns)
+    {
+        int r, c;
+        return chunkFor(rows, columns, r, c).mines.test(r, c);
+    }
+
+    bool isOpen(int rows, int columns)
+    {
+        int r, c;
+        return chunkFor(rows, columns, r, c).opened.test(r, c);
+    }
+
+    bool isFlagged(int rows, int columns)
+    {
+        int r, c;
+        return chunkFor(rows, columns, r, c).flagged.test(r, c);
+    }
+
+    int mineCount(int rows, int columns)
+    {
+        int r, c;
+        return chunkFor(rows, columns, r, c).count(r, c);
+    }
+
+    int state() const { return gameOver; }
+    int score() const { return points; }
+    std::size_t loadedChunks() const { return chunks.size(); }
+
+    // true while a flood still has squares left to open
+    bool spreading() const { return next < frontier.size(); }
+
+    // place a flag, or remove it if the square is already flagged
+    bool toggleFlag(int rows, int columns)
+    {
+        int r, c;
+        Chunk& chunk = chunkFor(rows, columns, r, c);
+        if (gameOver != 0 || chunk.opened.test(r, c))
+            return false;
+        if (chunk.flagged.test(r, c))
+            chunk.flagged.reset(r, c);
+        else
+            chunk.flagged.set(r, c);
+        chunk.touched = true;
+        return true;
+    }
+
+    // left click on a square, an empty square starts a flood that spread() carries on
+    const ClickResult& open(int rows, int columns)
+    {
+        result.changed.clear();
+        result.accepted = result.hitMine = result.lostLife = result.ended = false;
+        int r, c;
+        Chunk& chunk = chunkFor(rows, columns, r, c);
+        if (gameOver != 0 || chunk.flagged.test(r, c) || chunk.opened.test(r, c))
+            return result;
+        result.accepted = true;
+        chunk.touched = true;
+        if (chunk.mines.test(r, c))
+        {
+            //a mine ends the game
+            chunk.opened.set(r, c);
+            result.changed.push_back({rows, columns});
+            result.hitMine = true;
+            result.ended = true;
+            gameOver = 1;
+            frontier.clear();
+            next = 0;
+            return result;
+        }
+        opened.clear();
+        openSafe(chunk, r, c, rows, columns);
+        result.changed.insert(result.changed.end(), opened.begin(), opened.end());
+        return result;
+    }
+
+    // open at most budget more squares of the running flood, so a flood across many chunks
+    // is spread over several frames; returns the squares opened this time
+    const std::vector<Cell>& spread(int budget)
+    {
+        opened.clear();
+        while (next < frontier.size() && static_cast<int>(opened.size()) < budget)
+        {
+            Cell cell = frontier[next++];
+            for (const Cell& step : NEIGHBOURS)
+            {
+                const int checkRow = cell.rows + step.rows;
+                const int checkColumn = cell.columns + step.columns;
+                int r, c;
+                Chunk& chunk = chunkFor(checkRow, checkColumn, r, c);
+                // if the square is not a mine and not open yet then open it
+                if (!chunk.mines.test(r, c) && !chunk.opened.test(r, c))
+                    openSafe(chunk, r, c, checkRow, checkColumn);
+            }
+        }
+        if (next == frontier.size())
+        {
+            frontier.clear();
+            next = 0;
+        }
+        return opened;
+    }
+
+    // drop chunks nobody has played in that are outside the given chunk range, they can be made again
+    void evict(int firstChunkRow, int firstChunkColumn, int lastChunkRow, int lastChunkColumn)
+    {
+        //a running flood may still reach any chunk, so keep everything until it is done
+        if (spreading())
+            return;
+        for (auto it = chunks.begin(); it != chunks.end();)
+        {
+            int chunkRow = static_cast<int>(static_cast<std::uint32_t>(it->first >> 32));
+            int chunkColumn = static_cast<int>(static_cast<std::uint32_t>(it->first));
+            bool inView = chunkRow >= firstChunkRow && chunkRow <= lastChunkRow && chunkColumn >= firstChunkColumn && chunkColumn <= lastChunkColumn;
+            if (!it->second.touched && !inView)
+                it = chunks.erase(it);
+            else
+                ++it;
+        }
+    }
+};
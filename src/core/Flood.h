@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "BitBoard.h"
+
+// squares opened by one click and the points they are worth
+struct RevealResult
+{
+    std::vector<Cell> cells;    // every square that became selected
+    int mines = 0;              // how many of those squares are mines
+    int score = 0;              // points earned by those squares
+};
+
+// breadth first reveal that runs once per click, its buffers are sized for the whole board up front
+class FloodFill
+{
+private:
+    std::vector<Cell> queue;    // empty squares whose neighbours still need opening
+    std::size_t next = 0;       // front of the queue
+    RevealResult result;        // reused by every reveal
+
+    // select a square and remember it, empty squares also get their neighbours opened
+    void open(const MineCounts& mineCounts, BitPlane& selected, int rows, int columns, int points)
+    {
+        selected.set(rows, columns);
+        result.cells.push_back({rows, columns});
+        result.score += points;
+        if (mineCounts.at(rows, columns) == 0)
+            queue.push_back({rows, columns});
+    }
+
+    // open every safe neighbour of the squares in the queue until no empty squares are left
+    void spread(const BitPlane& grid, const MineCounts& mineCounts, BitPlane& selected, int points)
+    {
+        while (next < queue.size())
+        {
+            Cell cell = queue[next++];
+            openNeighbours(grid, mineCounts, selected, cell.rows, cell.columns, points);
+        }
+    }
+
+    void openNeighbours(const BitPlane& grid, const MineCounts& mineCounts, BitPlane& selected, int rows, int columns, int points)
+    {
+        //look at the 8 neighbors that stay on the board
+        for (const Cell& step : NEIGHBOURS)
+        {
+            const int checkRow = rows + step.rows;
+            const int checkColumn = columns + step.columns;
+            if (checkRow < 0 || checkRow >= grid.rows() || checkColumn < 0 || checkColumn >= grid.columns())
+                continue;
+            // if the square is not a mine and not open yet then open it
+            if (!grid.test(checkRow, checkColumn) && !selected.test(checkRow, checkColumn))
+                open(mineCounts, selected, checkRow, checkColumn, points);
+        }
+    }
+
+    void start()
+    {
+        queue.clear();
+        next = 0;
+        result.cells.clear();
+        result.mines = 0;
+        result.score = 0;
+    }
+
+public:
+    explicit FloodFill(int squares)
+    {
+        queue.reserve(squares);
+        result.cells.reserve(squares);
+    }
+
+    // select a clicked square, an empty square opens its whole connected empty area
+    // and the numbers around it, every safe square opened is worth points
+    const RevealResult& reveal(const BitPlane& grid, const MineCounts& mineCounts, BitPlane& selected, int rows, int columns, int points)
+    {
+        start();
+        if (selected.test(rows, columns))
+            return result;
+        if (grid.test(rows, columns))
+        {
+            //a mine is only selected, it never spreads
+            selected.set(rows, columns);
+            result.cells.push_back({rows, columns});
+            result.mines = 1;
+            return result;
+        }
+        open(mineCounts, selected, rows, columns, points);
+        spread(grid, mineCounts, selected, points);
+        return result;
+    }
+
+    // open the safe squares around a square (a found mine in demolition) and keep going through empty ones
+    const RevealResult& revealAround(const BitPlane& grid, const MineCounts& mineCounts, BitPlane& selected, int rows, int columns)
+    {
+        start();
+        openNeighbours(grid, mineCounts, selected, rows, columns, 0);
+        spread(grid, mineCounts, selected, 0);
+        return result;
+    }
+};
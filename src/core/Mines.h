@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include "BitBoard.h"
+
+// mix the bits of a word so nearby inputs give unrelated outputs (splitmix64 finaliser)
+inline std::uint64_t mixBits(std::uint64_t word)
+{
+    word += 0x9E3779B97F4A7C15ULL;
+    word = (word ^ (word >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    word = (word ^ (word >> 27)) * 0x94D049BB133111EBULL;
+    return word ^ (word >> 31);
+}
+
+// xoshiro256** generator, seeded through mixBits so any seed gives a good state;
+// seeding costs four mixes where std::mt19937_64 fills 312 words, which matters when a board lasts microseconds
+class Xoshiro256
+{
+private:
+    std::uint64_t state[4];
+
+    static std::uint64_t rotl(std::uint64_t word, int by) { return (word << by) | (word >> (64 - by)); }
+
+public:
+    using result_type = std::uint64_t;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    explicit Xoshiro256(std::uint64_t seed)
+    {
+        for (std::uint64_t& word : state)
+        {
+            seed = mixBits(seed);
+            word = seed;
+        }
+    }
+
+    result_type operator()()
+    {
+        const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const std::uint64_t shifted = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= shifted;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+};
+
+// seed used for the next board, a fixed seed from the command line makes every board repeatable
+class Seeds
+{
+private:
+    std::uint64_t fixed = 0;    // seed given with --seed
+    bool hasFixed = false;      // true once a seed was given
+    std::uint64_t last = 0;     // seed of the most recent board
+
+    static Seeds& instance()
+    {
+        static Seeds seeds;
+        return seeds;
+    }
+
+public:
+    // every board from now on uses this seed
+    static void setFixed(std::uint64_t seed)
+    {
+        instance().fixed = seed;
+        instance().hasFixed = true;
+    }
+
+    // seed for a new board, the fixed one if set, otherwise a fresh random one
+    static std::uint64_t next()
+    {
+        Seeds& seeds = instance();
+        if (seeds.hasFixed)
+            seeds.last = seeds.fixed;
+        else
+        {
+            std::random_device device;
+            seeds.last = (static_cast<std::uint64_t>(device()) << 32) ^ device();
+        }
+        return seeds.last;
+    }
+
+    // seed of the board being played, so it can be reproduced
+    static std::uint64_t current() { return instance().last; }
+};
+
+// place exactly mines mines on an empty plane, the same seed always gives the same board
+// Floyd's selection (a partial Fisher-Yates shuffle kept in the plane itself) costs one draw per mine
+inline void placeMines(BitPlane& grid, int mines, std::uint64_t seed)
+{
+    const int squares = grid.rows() * grid.columns();
+    if (mines > squares)
+        mines = squares;
+    Xoshiro256 engine(seed);
+    for (int last = squares - mines; last < squares; last++)
+    {
+        //pick from the first last+1 squares, if that one is taken the newest square is free
+        //the engine is written out here, so plain modulo keeps boards identical on every compiler
+        int square = static_cast<int>(engine() % static_cast<std::uint64_t>(last + 1));
+        if (grid.test(square / grid.columns(), square % grid.columns()))
+            square = last;
+        grid.set(square / grid.columns(), square % grid.columns());
+    }
+}
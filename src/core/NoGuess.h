@@ -0,0 +1,202 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Board.h"
+#include "Mines.h"
+#include "Solver.h"
+
+// a classic board that can be finished from start without ever guessing
+struct NoGuessBoard
+{
+    std::uint64_t seed; // mines as laid out by Board::generate
+    Cell start;         // square to open first, always an opening
+};
+
+// squares the no guess boards are opened from, the middle of the board
+inline Cell noGuessStart(int rows, int columns)
+{
+    return {rows / 2, columns / 2};
+}
+
+// lay out one board from seed and play it with certain moves only, true when that wins it;
+// the start square has to be an opening so the first click always gives the solver something
+inline bool solvesWithoutGuessing(Board& board, Solver& solver, std::uint64_t seed, Cell start)
+{
+    board.generate(seed);
+    if (board.isMine(start.rows, start.columns) || board.mineCount(start.rows, start.columns) != 0)
+        return false;
+    solver.reset();
+    solver.observe(board, board.open(start.rows, start.columns).changed);
+    while (!board.finished())
+    {
+        std::optional<Hint> hint = solver.hint();
+        if (!hint || !hint->certain)
+            return false;
+        solver.observe(board, board.open(hint->cell.rows, hint->cell.columns).changed);
+    }
+    return board.state() == 2;
+}
+
+// builds no guess boards on its own thread ahead of time, a few for every board size asked for,
+// so starting or resetting a board takes one that is already checked instead of searching for it
+class BoardGenerator
+{
+private:
+    // boards of one size, with the boards ready to be played
+    struct Spec
+    {
+        int rows;
+        int columns;
+        int mines;
+        std::deque<NoGuessBoard> ready;
+    };
+
+    static constexpr std::size_t READY = 3;     // boards kept ready per size
+
+    std::vector<Spec> specs;
+    std::size_t current = 0;                    // size being played, filled before the others
+    bool on = false;                            // boards are only built while the option is on
+    std::uint64_t stream;                       // candidate seeds come from here
+    std::mutex lock;                            // guards everything above
+    std::condition_variable wake;               // a board was taken or the option turned on
+    std::condition_variable built;              // a board became ready
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+
+    std::size_t find(int rows, int columns, int mines)
+    {
+        for (std::size_t i = 0; i < specs.size(); i++)
+        {
+            if (specs[i].rows == rows && specs[i].columns == columns && specs[i].mines == mines)
+                return i;
+        }
+        specs.push_back({rows, columns, mines, {}});
+        return specs.size() - 1;
+    }
+
+    // the size most in need of a board, the one being played first; false when all are full
+    bool pick(std::size_t& wanted) const
+    {
+        if (!on)
+            return false;
+        if (current < specs.size() && specs[current].ready.size() < READY)
+        {
+            wanted = current;
+            return true;
+        }
+        for (std::size_t i = 0; i < specs.size(); i++)
+        {
+            if (specs[i].ready.size() < READY)
+            {
+                wanted = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run()
+    {
+        while (true)
+        {
+            std::size_t wanted = 0;
+            int rows, columns, mines;
+            std::uint64_t seed;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                wake.wait(guard, [&] { return stopping.load() || pick(wanted); });
+                if (stopping)
+                    return;
+                rows = specs[wanted].rows;
+                columns = specs[wanted].columns;
+                mines = specs[wanted].mines;
+                seed = stream;
+                stream = mixBits(stream);
+            }
+            //search without the lock, checking for shutdown between tries
+            Board board(rows, columns, mines, GameMode::Classic);
+            Solver solver(rows, columns, mines);
+            const Cell start = noGuessStart(rows, columns);
+            while (!stopping && !solvesWithoutGuessing(board, solver, seed, start))
+                seed = mixBits(seed);
+            if (stopping)
+                return;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                //the list only grows, so the size is still at the same place
+                specs[wanted].ready.push_back({seed, start});
+            }
+            built.notify_all();
+        }
+    }
+
+    BoardGenerator() : stream(mixBits(Seeds::next())), worker([this] { run(); }) {}
+
+public:
+    ~BoardGenerator()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        worker.join();
+    }
+
+    BoardGenerator(const BoardGenerator&) = delete;
+    BoardGenerator& operator=(const BoardGenerator&) = delete;
+
+    // one generator for the whole game, its thread starts the first time it is used
+    static BoardGenerator& shared()
+    {
+        static BoardGenerator generator;
+        return generator;
+    }
+
+    bool enabled()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return on;
+    }
+
+    void setEnabled(bool enable)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            on = enable;
+        }
+        wake.notify_all();
+    }
+
+    // start building boards of this size before anyone asks for one
+    void prepare(int rows, int columns, int mines)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            find(rows, columns, mines);
+        }
+        wake.notify_all();
+    }
+
+    // a ready board of this size, waiting only if the generator has not caught up yet;
+    // the size becomes the one refilled first
+    NoGuessBoard take(int rows, int columns, int mines)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        current = find(rows, columns, mines);
+        on = true;      //never wait on a generator that is switched off
+        wake.notify_all();
+        const std::size_t wanted = current;
+        built.wait(guard, [&] { return !specs[wanted].ready.empty(); });
+        NoGuessBoard board = specs[wanted].ready.front();
+        specs[wanted].ready.pop_front();
+        guard.unlock();
+        wake.notify_all();
+        return board;
+    }
+};
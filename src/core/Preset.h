@@ -0,0 +1,140 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Board.h"
+
+// where a board sits on screen and the tables for finding its squares, all of it made at compile time
+// by a BoardPreset; boards without a preset (the endless board) work the sizes out at runtime instead
+struct BoardLayout
+{
+    int rows;
+    int columns;
+    int originX;                    // left of the board in pixels
+    int originY;                    // top of the board
+    int cellSize;                   // pixels per square
+    const int* tileX;               // left edge of each row of tiles
+    const int* tileY;               // top edge of each column of tiles
+    const std::uint16_t* rowAt;     // row under each pixel across the board, rows * cellSize of them
+    const std::uint16_t* columnAt;  // column under each pixel down the board, columns * cellSize of them
+};
+
+// one fixed board: its size, mines and rules, and where it is drawn, given once as template
+// arguments so every number the game uses for it comes from the same place
+template <int Rows, int Columns, int Mines, GameMode Mode, int OriginX, int OriginY, int CellSize>
+struct BoardPreset
+{
+    static_assert(Rows > 0 && Columns > 0 && CellSize > 0, "a board needs squares");
+    static_assert(Mines >= 0 && Mines < Rows * Columns, "a board needs a safe square to start on");
+    static_assert(Rows * CellSize <= 65536 && Columns * CellSize <= 65536, "the pixel tables hold 16 bit squares");
+
+    static constexpr int rows = Rows;
+    static constexpr int columns = Columns;
+    static constexpr int mines = Mines;
+    static constexpr GameMode mode = Mode;
+    static constexpr int originX = OriginX;
+    static constexpr int originY = OriginY;
+    static constexpr int cellSize = CellSize;
+    static constexpr int squares = Rows * Columns;
+
+private:
+    template <int Count>
+    static constexpr std::array<int, Count> edges(int start)
+    {
+        std::array<int, Count> edge{};
+        for (int i = 0; i < Count; i++)
+            edge[i] = start + i * CellSize;
+        return edge;
+    }
+
+    template <int Count>
+    static constexpr std::array<std::uint16_t, Count * CellSize> squareAt()
+    {
+        std::array<std::uint16_t, Count * CellSize> square{};
+        for (int pixel = 0; pixel < Count * CellSize; pixel++)
+            square[pixel] = static_cast<std::uint16_t>(pixel / CellSize);
+        return square;
+    }
+
+public:
+    static constexpr std::array<int, Rows> tileX = edges<Rows>(OriginX);
+    static constexpr std::array<int, Columns> tileY = edges<Columns>(OriginY);
+    static constexpr std::array<std::uint16_t, Rows * CellSize> rowAt = squareAt<Rows>();
+    static constexpr std::array<std::uint16_t, Columns * CellSize> columnAt = squareAt<Columns>();
+    static constexpr BoardLayout layout{Rows, Columns, OriginX, OriginY, CellSize, tileX.data(), tileY.data(), rowAt.data(), columnAt.data()};
+
+    // the board keeps runtime sized planes; a row stride fixed at compile time was measured on every
+    // shipped size (one word per row, two for the large board) and was no faster, so no storage per preset
+    static Board board() { return Board(Rows, Columns, Mines, Mode); }
+};
+
+// a point on the 1920 by 1080 screen
+struct ScreenPoint
+{
+    int x;
+    int y;
+};
+
+// what is drawn around a preset's board and how it is named; kept with the board's numbers so the
+// screens, the simulator and the bench all read them from here. Only demolition shows lives
+struct PresetScreen
+{
+    const char* name;           // as the tools and --race take it
+    const char* background;     // screen image behind the board
+    const char* skin;           // tile set
+    unsigned scoreSize;         // character size of the score
+    ScreenPoint score;          // where the score is written
+    ScreenPoint livesLabel;     // where "Lives:" is written
+    ScreenPoint lives;          // and the lives left after it
+    float ringDuration;         // how long a mine's ring wave grows for
+};
+
+// the boards the game ships with
+struct EasyPreset : BoardPreset<10, 10, 10, GameMode::Classic, 712, 289, 50>
+{
+    static constexpr PresetScreen screen{"easy", "Minesweeper_easy.png", "Easy", 50, {911, 225}, {0, 0}, {0, 0}, 0.15f};
+};
+struct MediumPreset : BoardPreset<20, 20, 60, GameMode::Classic, 610, 190, 35>
+{
+    static constexpr PresetScreen screen{"medium", "Minesweeper_medium.png", "Medium", 55, {849, 110}, {0, 0}, {0, 0}, 0.1f};
+};
+struct HardPreset : BoardPreset<30, 30, 180, GameMode::Classic, 511, 93, 30>
+{
+    static constexpr PresetScreen screen{"hard", "Minesweeper_hard.png", "Hard", 60, {765, 10}, {0, 0}, {0, 0}, 0.1f};
+};
+struct DemolitionPreset : BoardPreset<20, 20, 60, GameMode::Demolition, 610, 190, 35>
+{
+    static constexpr PresetScreen screen{"demolition", "Minesweeper_demolition.png", "Medium", 55, {849, 110}, {1040, 110}, {1250, 115}, 0.1f};
+};
+// raced on, seen through the hard board's frame
+struct LargePreset : BoardPreset<100, 100, 2000, GameMode::Classic, 511, 93, 30>
+{
+    static constexpr PresetScreen screen{"large", "Minesweeper_hard.png", "Hard", 60, {765, 10}, {0, 0}, {0, 0}, 0.1f};
+};
+
+// a board's size, rules and look as plain values, for the tools that pick boards by name at runtime
+struct PresetInfo
+{
+    std::string name;
+    int rows;
+    int columns;
+    int mines;
+    GameMode mode;
+    PresetScreen screen;
+    const BoardLayout* layout;
+};
+
+template <class Preset>
+PresetInfo presetInfo()
+{
+    return {Preset::screen.name, Preset::rows, Preset::columns, Preset::mines, Preset::mode, Preset::screen, &Preset::layout};
+}
+
+// every shipped board, in the order the tools list them
+inline const std::vector<PresetInfo>& shippedPresets()
+{
+    static const std::vector<PresetInfo> presets{presetInfo<EasyPreset>(), presetInfo<MediumPreset>(), presetInfo<HardPreset>(),
+                                                 presetInfo<DemolitionPreset>(), presetInfo<LargePreset>()};
+    return presets;
+}
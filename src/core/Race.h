@@ -0,0 +1,407 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "BitBoard.h"
+#include "Board.h"
+#include "Preset.h"
+#include "Replay.h"
+
+// head to head races on one seeded board; the server plays every player's moves on its own copy of
+// the board and is the one that counts, clients play their moves at once and are corrected after.
+// Messages are a type byte then varints, transport is up to the caller:
+//   Start     server to one client: player index, players, then the board as putHeader writes it
+//   Moves     client to server: sequence of the first move, move count, square * 2 + action per move
+//   Progress  server to every client: count of players that changed, then per player its index,
+//             moves received, moves played, score, state, lives and plane diffs of opened and flagged
+//             squares since the last progress; then 1 and the winner + 1 (0 for a draw) once the race is over, else 0
+// a plane diff is pairs of varints, squares left as they were then squares that flipped, ended by a pair with no flips
+enum class RaceMessage : std::uint8_t
+{
+    Start,
+    Moves,
+    Progress,
+};
+
+// write the squares that differ between two planes of the same size as runs over the squares in order
+inline void putPlaneDiff(std::vector<std::uint8_t>& bytes, const BitPlane& before, const BitPlane& after)
+{
+    std::uint64_t runEnd = 0;       // square after the last flipped run written
+    std::uint64_t runStart = 0;     // first square of the run being collected
+    std::uint64_t runLength = 0;
+    for (int rows = 0; rows < after.rows(); rows++)
+    {
+        const std::uint64_t* was = before.row(rows);
+        const std::uint64_t* now = after.row(rows);
+        for (int word = 0; word < after.rowWords(); word++)
+        {
+            std::uint64_t flipped = was[word] ^ now[word];
+            while (flipped)
+            {
+                const int bit = lowestBit64(flipped);
+                flipped &= flipped - 1;
+                const std::uint64_t square = static_cast<std::uint64_t>(rows) * after.columns() + word * 64 + bit;
+                if (runLength > 0 && square == runStart + runLength)
+                {
+                    runLength++;
+                    continue;
+                }
+                if (runLength > 0)
+                {
+                    putVarint(bytes, runStart - runEnd);
+                    putVarint(bytes, runLength);
+                    runEnd = runStart + runLength;
+                }
+                runStart = square;
+                runLength = 1;
+            }
+        }
+    }
+    if (runLength > 0)
+    {
+        putVarint(bytes, runStart - runEnd);
+        putVarint(bytes, runLength);
+    }
+    putVarint(bytes, 0);
+    putVarint(bytes, 0);
+}
+
+// flip the squares a plane diff names, false when it is cut off or runs off the plane
+inline bool applyPlaneDiff(const std::uint8_t*& at, const std::uint8_t* end, BitPlane& plane)
+{
+    const std::uint64_t squares = static_cast<std::uint64_t>(plane.rows()) * plane.columns();
+    std::uint64_t square = 0;
+    while (true)
+    {
+        std::uint64_t skip, flips;
+        if (!getVarint(at, end, skip) || !getVarint(at, end, flips))
+            return false;
+        if (flips == 0)
+            return true;
+        if (skip > squares - square || flips > squares - square - skip)
+            return false;
+        for (square += skip; flips > 0; flips--, square++)
+        {
+            const int rows = static_cast<int>(square / plane.columns());
+            const int columns = static_cast<int>(square % plane.columns());
+            if (plane.test(rows, columns))
+                plane.reset(rows, columns);
+            else
+                plane.set(rows, columns);
+        }
+    }
+}
+
+// what a race looks like to everyone, one per player
+struct RacePlayer
+{
+    BitPlane opened;
+    BitPlane flagged;
+    int score = 0;
+    int state = 0;          // as Board::state, 0 still playing, 1 lost, 2 won
+    int lives = 0;
+
+    RacePlayer(int rows, int columns) : opened(rows, columns), flagged(rows, columns) {}
+};
+
+// the side that counts: plays every player's moves on its own board and sends out what changed.
+// The first player to win ends the race, once every player has lost the best score wins;
+// moves that arrive after the race is over are counted as received but not played
+class RaceServer
+{
+private:
+    struct Player
+    {
+        Board board;
+        RacePlayer sent;            // what the clients were last told
+        std::uint64_t received = 0;
+        std::uint64_t played = 0;
+        std::uint64_t sentReceived = 0;
+        std::uint64_t sentPlayed = 0;
+
+        explicit Player(const ReplayHeader& game)
+            : board(game.rows, game.columns, game.mines, game.mode), sent(game.rows, game.columns)
+        {
+            board.generate(game.seed);
+            sent.lives = board.lives();
+        }
+    };
+
+    ReplayHeader game;
+    std::vector<std::unique_ptr<Player>> players;    // boards are large, so they are never moved
+    bool raceOver = false;
+    bool overSent = false;
+    int winner = -1;
+
+    void checkOver()
+    {
+        if (raceOver)
+            return;
+        bool allLost = true;
+        for (std::size_t i = 0; i < players.size(); i++)
+        {
+            if (players[i]->board.state() == 2)
+            {
+                raceOver = true;
+                winner = static_cast<int>(i);
+                return;
+            }
+            allLost = allLost && players[i]->board.state() == 1;
+        }
+        if (!allLost)
+            return;
+        raceOver = true;
+        winner = 0;
+        bool tied = false;
+        for (std::size_t i = 1; i < players.size(); i++)
+        {
+            const int score = players[i]->board.score();
+            const int best = players[static_cast<std::size_t>(winner)]->board.score();
+            if (score > best)
+                winner = static_cast<int>(i), tied = false;
+            else if (score == best)
+                tied = true;
+        }
+        if (tied)
+            winner = -1;
+    }
+
+public:
+    RaceServer(const ReplayHeader& gameIn, int playerCount) : game(gameIn)
+    {
+        for (int i = 0; i < playerCount; i++)
+            players.push_back(std::make_unique<Player>(game));
+    }
+
+    const ReplayHeader& header() const { return game; }
+    int size() const { return static_cast<int>(players.size()); }
+    bool over() const { return raceOver; }
+
+    // the message a player's client starts from
+    void start(int player, std::vector<std::uint8_t>& bytes) const
+    {
+        bytes.clear();
+        bytes.push_back(static_cast<std::uint8_t>(RaceMessage::Start));
+        putVarint(bytes, static_cast<std::uint64_t>(player));
+        putVarint(bytes, players.size());
+        putHeader(bytes, game);
+    }
+
+    // a Moves message from a player's client, false when it is not one or does not follow on
+    bool receive(int player, const std::uint8_t* data, std::size_t size)
+    {
+        const std::uint8_t* at = data;
+        const std::uint8_t* end = data + size;
+        Player& from = *players[static_cast<std::size_t>(player)];
+        std::uint64_t first, count;
+        if (size == 0 || *at++ != static_cast<std::uint8_t>(RaceMessage::Moves) || !getVarint(at, end, first) ||
+            !getVarint(at, end, count) || first != from.received)
+            return false;
+        const std::uint64_t squares = static_cast<std::uint64_t>(game.rows) * game.columns;
+        for (std::uint64_t i = 0; i < count; i++)
+        {
+            std::uint64_t packed;
+            if (!getVarint(at, end, packed) || packed / 2 >= squares)
+                return false;
+            from.received++;
+            if (raceOver)
+                continue;
+            const std::uint64_t square = packed / 2;
+            applyMove(from.board, {0, static_cast<int>(square / game.columns), static_cast<int>(square % game.columns),
+                                   static_cast<ReplayAction>(packed & 1)});
+            from.played++;
+            checkOver();
+        }
+        return true;
+    }
+
+    // one network tick: a Progress message of the players that changed since the last one,
+    // false when there is nothing new to send
+    bool progress(std::vector<std::uint8_t>& bytes)
+    {
+        std::vector<std::size_t> changed;
+        for (std::size_t i = 0; i < players.size(); i++)
+        {
+            const Player& player = *players[i];
+            if (player.received != player.sentReceived || player.played != player.sentPlayed ||
+                player.board.score() != player.sent.score || player.board.state() != player.sent.state ||
+                player.board.lives() != player.sent.lives)
+                changed.push_back(i);
+        }
+        if (changed.empty() && (!raceOver || overSent))
+            return false;
+        bytes.clear();
+        bytes.push_back(static_cast<std::uint8_t>(RaceMessage::Progress));
+        putVarint(bytes, changed.size());
+        for (std::size_t i : changed)
+        {
+            Player& player = *players[i];
+            putVarint(bytes, i);
+            putVarint(bytes, player.received);
+            putVarint(bytes, player.played);
+            putVarint(bytes, static_cast<std::uint64_t>(player.board.score() < 0 ? 0 : player.board.score()));
+            bytes.push_back(static_cast<std::uint8_t>(player.board.state()));
+            putVarint(bytes, static_cast<std::uint64_t>(player.board.lives() < 0 ? 0 : player.board.lives()));
+            putPlaneDiff(bytes, player.sent.opened, player.board.openPlane());
+            putPlaneDiff(bytes, player.sent.flagged, player.board.flagPlane());
+            player.sent.opened = player.board.openPlane();
+            player.sent.flagged = player.board.flagPlane();
+            player.sent.score = player.board.score();
+            player.sent.state = player.board.state();
+            player.sent.lives = player.board.lives();
+            player.sentReceived = player.received;
+            player.sentPlayed = player.played;
+        }
+        bytes.push_back(raceOver ? 1 : 0);
+        if (raceOver)
+            putVarint(bytes, static_cast<std::uint64_t>(winner + 1));
+        overSent = raceOver;
+        return true;
+    }
+};
+
+// one player's side: moves are played on the local board straight away and batched for the server,
+// the server's progress keeps every player's view up to date and corrects the local board if it differs
+class RaceClient
+{
+private:
+    ReplayHeader game;
+    int self = -1;
+    std::vector<RacePlayer> views;
+    std::vector<std::uint64_t> moves;   // square * 2 + action of every move made here, in order
+    std::size_t sent = 0;               // moves already batched
+    std::uint64_t received = 0;         // this player's moves the server has seen
+    std::uint64_t played = 0;           // and of those the ones it played
+    bool raceOver = false;
+    int winner = -1;
+    bool unchecked = false;             // progress came in that the local board was not compared with yet
+
+public:
+    // read the server's Start message, false when it is not one or is for a board this game does not have
+    bool start(const std::uint8_t* data, std::size_t size)
+    {
+        const std::uint8_t* at = data;
+        const std::uint8_t* end = data + size;
+        std::uint64_t player, count;
+        if (size == 0 || *at++ != static_cast<std::uint8_t>(RaceMessage::Start) || !getVarint(at, end, player) ||
+            !getVarint(at, end, count) || player >= count || count > 64 || !getHeader(at, end, game))
+            return false;
+        //only a shipped board can be played, so nothing is made for any other a server asks for
+        const std::vector<PresetInfo>& presets = shippedPresets();
+        if (std::none_of(presets.begin(), presets.end(), [&](const PresetInfo& preset)
+            {
+                return preset.mode == game.mode && preset.rows == game.rows && preset.columns == game.columns && preset.mines == game.mines;
+            }))
+            return false;
+        self = static_cast<int>(player);
+        views.assign(static_cast<std::size_t>(count), RacePlayer(game.rows, game.columns));
+        return true;
+    }
+
+    bool started() const { return self >= 0; }
+    const ReplayHeader& header() const { return game; }
+    int player() const { return self; }
+    int players() const { return static_cast<int>(views.size()); }
+    const RacePlayer& view(int player) const { return views[static_cast<std::size_t>(player)]; }
+    bool over() const { return raceOver; }
+    int raceWinner() const { return winner; }
+
+    // a move made on the local board, played there or on its way to being played
+    void play(int rows, int columns, ReplayAction action)
+    {
+        moves.push_back((static_cast<std::uint64_t>(rows) * game.columns + columns) * 2 + static_cast<std::uint64_t>(action));
+    }
+
+    // the moves made since the last batch as a Moves message, false when there are none
+    bool batch(std::vector<std::uint8_t>& bytes)
+    {
+        if (sent == moves.size())
+            return false;
+        bytes.clear();
+        bytes.push_back(static_cast<std::uint8_t>(RaceMessage::Moves));
+        putVarint(bytes, sent);
+        putVarint(bytes, moves.size() - sent);
+        for (; sent < moves.size(); sent++)
+            putVarint(bytes, moves[sent]);
+        return true;
+    }
+
+    // read a Progress message, false when malformed; the local board is compared with it by reconcile
+    bool receive(const std::uint8_t* data, std::size_t size)
+    {
+        const std::uint8_t* at = data;
+        const std::uint8_t* end = data + size;
+        std::uint64_t count;
+        if (size == 0 || *at++ != static_cast<std::uint8_t>(RaceMessage::Progress) || !getVarint(at, end, count))
+            return false;
+        for (std::uint64_t i = 0; i < count; i++)
+        {
+            std::uint64_t player, movesReceived, movesPlayed, score, lives;
+            if (!getVarint(at, end, player) || player >= views.size() || !getVarint(at, end, movesReceived) ||
+                !getVarint(at, end, movesPlayed) || !getVarint(at, end, score) || at == end)
+                return false;
+            RacePlayer& view = views[static_cast<std::size_t>(player)];
+            view.score = static_cast<int>(score);
+            view.state = *at++;
+            if (!getVarint(at, end, lives) || !applyPlaneDiff(at, end, view.opened) || !applyPlaneDiff(at, end, view.flagged))
+                return false;
+            view.lives = static_cast<int>(lives);
+            if (static_cast<int>(player) == self)
+            {
+                received = movesReceived;
+                played = movesPlayed;
+            }
+        }
+        if (at == end)
+            return false;
+        if (*at++ == 1)
+        {
+            std::uint64_t winnerIndex;
+            if (!getVarint(at, end, winnerIndex))
+                return false;
+            raceOver = true;
+            winner = static_cast<int>(winnerIndex) - 1;
+        }
+        unchecked = true;
+        return true;
+    }
+
+    // true while there is progress the local board has not been compared with
+    bool needsCheck() const { return unchecked; }
+
+    // compare the local board with the server's last progress and bring it back to the server's if
+    // it differs: the board is laid out again and only the moves the server played are made; true
+    // when it was, so the caller draws it all again. board has to hold every move passed to play
+    // and no others
+    bool reconcile(Board& board)
+    {
+        if (!unchecked)
+            return false;
+        unchecked = false;
+        //once the server has seen every move the boards have to agree, and moves it turned down
+        //after the race ended have to come off the local board
+        const RacePlayer& mine = views[static_cast<std::size_t>(self)];
+        if (!(raceOver && played < moves.size()) &&
+            !(received == moves.size() && played == received && (mine.opened != board.openPlane() || mine.flagged != board.flagPlane())))
+            return false;
+        board.generate(game.seed);
+        const std::uint64_t squares = static_cast<std::uint64_t>(game.rows) * game.columns;
+        const std::size_t keep = static_cast<std::size_t>(std::min<std::uint64_t>(played, moves.size()));
+        for (std::size_t i = 0; i < keep; i++)
+        {
+            const std::uint64_t square = moves[i] / 2;
+            if (square < squares)
+                applyMove(board, {0, static_cast<int>(square / game.columns), static_cast<int>(square % game.columns),
+                                  static_cast<ReplayAction>(moves[i] & 1)});
+        }
+        //the rest came after the end of the race and were turned down
+        if (raceOver)
+        {
+            moves.resize(keep);
+            sent = std::min(sent, keep);
+        }
+        return true;
+    }
+};
@@ -0,0 +1,207 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Board.h"
+
+// a recorded game is the board it was played on and the moves made, a few bytes per move:
+//   header   "MSR1", mode byte, then varints rows, columns, mines and the seed Board::generate was given
+//   moves    until the end, each a varint of milliseconds since the move before and a varint of
+//            square * 2 + action, square being rows * columns + columns as everywhere else
+// varints hold 7 bits a byte, lowest first, with the top bit set on every byte but the last
+constexpr char REPLAY_MAGIC[4] = {'M', 'S', 'R', '1'};
+// most squares a header may ask for, far above the largest shipped board and small enough to allocate
+constexpr std::uint64_t HEADER_MAX_SQUARES = 1 << 20;
+
+// add a varint to the end of bytes
+inline void putVarint(std::vector<std::uint8_t>& bytes, std::uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<std::uint8_t>(value));
+}
+
+// read a varint and move at past it, false when it runs past end or over 64 bits
+inline bool getVarint(const std::uint8_t*& at, const std::uint8_t* end, std::uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && at < end; shift += 7)
+    {
+        const std::uint8_t byte = *at++;
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+// what a move did to its square
+enum class ReplayAction : std::uint8_t
+{
+    Open,
+    Flag,   // placed or took away a flag
+};
+
+// the board a replay was played on
+struct ReplayHeader
+{
+    GameMode mode = GameMode::Classic;
+    int rows = 0;
+    int columns = 0;
+    int mines = 0;
+    std::uint64_t seed = 0;
+};
+
+// write a board's mode byte and the varints of its size, mines and seed
+inline void putHeader(std::vector<std::uint8_t>& bytes, const ReplayHeader& header)
+{
+    bytes.push_back(static_cast<std::uint8_t>(header.mode));
+    putVarint(bytes, static_cast<std::uint64_t>(header.rows));
+    putVarint(bytes, static_cast<std::uint64_t>(header.columns));
+    putVarint(bytes, static_cast<std::uint64_t>(header.mines));
+    putVarint(bytes, header.seed);
+}
+
+// read what putHeader wrote, false when it is cut off or the board makes no sense
+inline bool getHeader(const std::uint8_t*& at, const std::uint8_t* end, ReplayHeader& header)
+{
+    if (at == end)
+        return false;
+    const std::uint8_t mode = *at++;
+    std::uint64_t rows, columns, mines;
+    if (mode > static_cast<std::uint8_t>(GameMode::Demolition) || !getVarint(at, end, rows) || !getVarint(at, end, columns) ||
+        !getVarint(at, end, mines) || !getVarint(at, end, header.seed))
+        return false;
+    if (rows == 0 || columns == 0 || rows > HEADER_MAX_SQUARES || columns > HEADER_MAX_SQUARES ||
+        rows * columns > HEADER_MAX_SQUARES || mines > rows * columns)
+        return false;
+    header.mode = static_cast<GameMode>(mode);
+    header.rows = static_cast<int>(rows);
+    header.columns = static_cast<int>(columns);
+    header.mines = static_cast<int>(mines);
+    return true;
+}
+
+// one move of a replay
+struct ReplayMove
+{
+    std::uint64_t tick;     // milliseconds since the board was shown
+    int rows;
+    int columns;
+    ReplayAction action;
+};
+
+// builds a replay in memory as the game is played
+class ReplayRecorder
+{
+private:
+    std::vector<std::uint8_t> bytes;
+    int columnCount = 0;
+    std::uint64_t lastTick = 0;
+    std::size_t moveCount = 0;
+
+public:
+    // forget any moves and start recording a game on this board
+    void start(const ReplayHeader& header)
+    {
+        bytes.assign(REPLAY_MAGIC, REPLAY_MAGIC + sizeof(REPLAY_MAGIC));
+        putHeader(bytes, header);
+        columnCount = header.columns;
+        lastTick = 0;
+        moveCount = 0;
+    }
+
+    // ticks never go backwards, a move stamped earlier than the last is kept at the same tick
+    void add(const ReplayMove& move)
+    {
+        const std::uint64_t tick = move.tick < lastTick ? lastTick : move.tick;
+        putVarint(bytes, tick - lastTick);
+        putVarint(bytes, (static_cast<std::uint64_t>(move.rows) * columnCount + move.columns) * 2 + static_cast<std::uint64_t>(move.action));
+        lastTick = tick;
+        moveCount++;
+    }
+
+    std::size_t moves() const { return moveCount; }
+    const std::vector<std::uint8_t>& data() const { return bytes; }
+
+    bool save(const std::string& path) const
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return static_cast<bool>(file);
+    }
+};
+
+// reads a replay straight from memory (a mapped file or a recorder's bytes) without copying it
+class ReplayReader
+{
+private:
+    const std::uint8_t* at;
+    const std::uint8_t* end;
+    ReplayHeader head;
+    std::uint64_t tick = 0;
+    bool good = false;
+
+public:
+    // reads the header, valid() is false when it is not a replay or its board makes no sense
+    ReplayReader(const void* data, std::size_t size)
+        : at(static_cast<const std::uint8_t*>(data)), end(static_cast<const std::uint8_t*>(data) + size)
+    {
+        if (size < sizeof(REPLAY_MAGIC) || std::memcmp(at, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0)
+            return;
+        at += sizeof(REPLAY_MAGIC);
+        good = getHeader(at, end, head);
+    }
+
+    bool valid() const { return good; }
+    const ReplayHeader& header() const { return head; }
+    // tick of the last move read, the length of the game once every move is read
+    std::uint64_t lastTick() const { return tick; }
+
+    // the next move, false at the end of the replay or at a move that is cut off or off the board
+    bool next(ReplayMove& move)
+    {
+        std::uint64_t delta, packed;
+        if (!good || at == end || !getVarint(at, end, delta) || !getVarint(at, end, packed))
+            return false;
+        const std::uint64_t square = packed / 2;
+        if (square >= static_cast<std::uint64_t>(head.rows) * static_cast<std::uint64_t>(head.columns))
+            return false;
+        tick += delta;
+        move = {tick, static_cast<int>(square / head.columns), static_cast<int>(square % head.columns), static_cast<ReplayAction>(packed & 1)};
+        return true;
+    }
+};
+
+// apply one recorded move to a board, the click's result for an open and nullptr for a flag
+inline const ClickResult* applyMove(Board& board, const ReplayMove& move)
+{
+    if (move.action == ReplayAction::Flag)
+    {
+        board.toggleFlag(move.rows, move.columns);
+        return nullptr;
+    }
+    return &board.open(move.rows, move.columns);
+}
+
+// lay out a replay's board and play its moves through the rules with nothing drawn, stopping after
+// upTo moves so any point of the game can be jumped to; board has to be the header's size and mode.
+// gives back the number of moves played
+inline std::size_t playReplay(Board& board, ReplayReader& reader, std::size_t upTo = SIZE_MAX)
+{
+    board.generate(reader.header().seed);
+    std::size_t played = 0;
+    ReplayMove move;
+    while (played < upTo && reader.next(move))
+    {
+        applyMove(board, move);
+        played++;
+    }
+    return played;
+}
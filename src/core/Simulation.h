@@ -0,0 +1,222 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "Board.h"
+#include "Solver.h"
+#include "Spsc.h"
+#include "TripleBuffer.h"
+
+// what the player asked the simulation to do
+enum class SimAction : std::uint8_t
+{
+    Open,
+    Flag,
+    Hint,   // find the square to open next, cell is ignored
+};
+
+// one input on its way to the simulation thread
+struct SimCommand
+{
+    SimAction action = SimAction::Open;
+    Cell cell{0, 0};
+    std::uint64_t seed = 0;     // hints sample the unknown squares from this
+    std::chrono::steady_clock::time_point inputTime{}; // when the window's event was read
+};
+
+// what one command did, sent back in order for sounds, effects, the replay and the race
+struct SimEvent
+{
+    SimCommand command;
+    std::uint64_t sequence = 0; // commands applied up to and including this one
+    bool accepted = false;      // the board changed
+    bool hitMine = false;
+    bool lostLife = false;
+    bool ended = false;
+    std::optional<Hint> hint;   // the answer to a hint command
+};
+
+// the board as the render thread sees it, a copy that is never changed once published
+struct BoardSnapshot
+{
+    // square bits: open, flagged, mine, then the mines around it from SQUARE_COUNT up
+    static constexpr std::uint8_t SQUARE_OPEN = 1;
+    static constexpr std::uint8_t SQUARE_FLAG = 2;
+    static constexpr std::uint8_t SQUARE_MINE = 4;
+    static constexpr int SQUARE_COUNT = 3;
+
+    std::vector<std::uint8_t> squares;  // rows * columns + columns as everywhere else
+    int score = 0;
+    int lives = 0;
+    int state = 0;                      // 0 playing, 1 lost, 2 won
+    std::uint64_t sequence = 0;         // commands applied when it was taken
+};
+
+// runs the rules of one board on its own thread at a fixed step: commands come in through a lock
+// free queue, and each step that changed something publishes a fresh snapshot through a triple
+// buffer and one event per command, so a slow frame never holds up the next click's rules
+class BoardSimulation
+{
+private:
+    static constexpr std::chrono::microseconds STEP{2000};     // 500 steps a second
+    static constexpr std::size_t QUEUE = 256;                   // commands or events in flight at once
+
+    Board board;
+    Solver solver;
+    bool demolition;
+    SpscQueue<SimCommand, QUEUE> commands;      // render thread to simulation
+    SpscQueue<SimEvent, QUEUE> events;          // simulation to render thread
+    TripleBuffer<BoardSnapshot> snapshots;
+    std::mutex borrowed;                        // held by a step changing the board and by withBoard
+    std::atomic<bool> changed{true};            // withBoard changed the board, publish on the next step
+    std::atomic<bool> stopping{false};
+    std::atomic<std::int64_t> rulesTime{0};     // nanoseconds spent in steps that changed something, not taken yet
+    std::uint64_t applied = 0;                  // simulation thread only
+    std::uint64_t sent = 0;                     // render thread only
+    std::thread worker;
+
+    void publish()
+    {
+        BoardSnapshot& snapshot = snapshots.writing();
+        std::uint8_t* square = snapshot.squares.data();
+        for (int rows = 0; rows < board.rows(); rows++)
+        {
+            for (int columns = 0; columns < board.columns(); columns++)
+            {
+                *square++ = static_cast<std::uint8_t>((board.isOpen(rows, columns) ? BoardSnapshot::SQUARE_OPEN : 0) |
+                                                      (board.isFlagged(rows, columns) ? BoardSnapshot::SQUARE_FLAG : 0) |
+                                                      (board.isMine(rows, columns) ? BoardSnapshot::SQUARE_MINE : 0) |
+                                                      (board.mineCount(rows, columns) << BoardSnapshot::SQUARE_COUNT));
+            }
+        }
+        snapshot.score = board.score();
+        snapshot.lives = board.lives();
+        snapshot.state = board.state();
+        snapshot.sequence = applied;
+        snapshots.publish();
+    }
+
+    // apply every waiting command there is room to report
+    void step()
+    {
+        const auto start = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> held(borrowed);
+        bool dirty = changed.exchange(false);
+        SimCommand command;
+        while (!events.full() && commands.pop(command))
+        {
+            SimEvent event;
+            event.command = command;
+            event.sequence = ++applied;
+            if (command.action == SimAction::Flag)
+                event.accepted = board.toggleFlag(command.cell.rows, command.cell.columns);
+            else if (command.action == SimAction::Hint)
+                event.hint = board.finished() ? std::nullopt : solver.hint(command.seed, demolition);
+            else
+            {
+                const ClickResult& opened = board.open(command.cell.rows, command.cell.columns);
+                if (opened.accepted)
+                    solver.observe(board, opened.changed);
+                event.accepted = opened.accepted;
+                event.hitMine = opened.hitMine;
+                event.lostLife = opened.lostLife;
+                event.ended = opened.ended;
+            }
+            //the render thread holds an event back until it has a snapshot this new, so the two always agree
+            dirty = true;
+            events.push(event);
+        }
+        if (!dirty)
+            return;
+        publish();
+        rulesTime.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(),
+                            std::memory_order_relaxed);
+    }
+
+    void run()
+    {
+        auto next = std::chrono::steady_clock::now();
+        while (!stopping.load(std::memory_order_relaxed))
+        {
+            step();
+            next += STEP;
+            const auto now = std::chrono::steady_clock::now();
+            //after a long step (a hint on a big board) carry on from now instead of running to catch up
+            if (now > next + STEP * 8)
+                next = now;
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+public:
+    BoardSimulation(int rows, int columns, int mines, GameMode mode)
+        : board(rows, columns, mines, mode), solver(rows, columns, mines), demolition(mode == GameMode::Demolition),
+          snapshots(BoardSnapshot{std::vector<std::uint8_t>(static_cast<std::size_t>(rows) * columns, 0), 0, 0, 0, 0})
+    {
+    }
+
+    ~BoardSimulation()
+    {
+        stopping = true;
+        if (worker.joinable())
+            worker.join();
+    }
+
+    BoardSimulation(const BoardSimulation&) = delete;
+    BoardSimulation& operator=(const BoardSimulation&) = delete;
+
+    // publish the board as withBoard set it up and start stepping, the first snapshot is there at once
+    void start()
+    {
+        publish();
+        changed = false;
+        worker = std::thread([this] { run(); });
+    }
+
+    // use the board and solver from the render thread between steps (setting up, a race correcting
+    // it); whatever is done shows in the next snapshot
+    template <class Use>
+    decltype(auto) withBoard(Use use)
+    {
+        std::lock_guard<std::mutex> held(borrowed);
+        changed = true;
+        return use(board, solver);
+    }
+
+    // render thread only, false when the queue is full and the input was dropped
+    bool send(const SimCommand& command)
+    {
+        if (!commands.push(command))
+            return false;
+        sent++;
+        return true;
+    }
+
+    // render thread only, take the newest snapshot; true when it changed
+    bool refresh() { return snapshots.update(); }
+    const BoardSnapshot& view() const { return snapshots.reading(); }
+
+    // render thread only, the next event the current snapshot already shows
+    bool nextEvent(SimEvent& event)
+    {
+        const SimEvent* waiting = events.front();
+        if (!waiting || waiting->sequence > view().sequence)
+            return false;
+        return events.pop(event);
+    }
+
+    // render thread only, commands sent that the current snapshot does not show yet
+    bool waiting() const { return view().sequence < sent; }
+
+    // render thread only, every command sent is on the board, in the snapshot and taken as an event,
+    // so the board holds exactly what was sent
+    bool settled() const { return !waiting() && !events.front(); }
+
+    // seconds the rules thread spent on steps that changed something since this was last asked
+    double takeRulesTime() { return static_cast<double>(rulesTime.exchange(0, std::memory_order_relaxed)) * 1e-9; }
+};
@@ -0,0 +1,687 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "BitBoard.h"
+#include "Board.h"
+#include "Mines.h"
+
+// what the solver suggests doing next
+struct Hint
+{
+    Cell cell;              // square to open
+    bool certain = false;   // the square is what was asked for without guessing
+    double probability = 0; // chance the square is a mine
+};
+
+// works out safe squares and mines from the opened numbers, keeping one constraint per open number
+// up to date as squares are opened instead of reading the whole board again;
+// when nothing is certain it falls back to mine probabilities over the frontier
+class Solver
+{
+private:
+    // Shown is a mine that has been opened, demolition boards open mines as they are found
+    enum State : std::uint8_t { Unknown, Open, Safe, Mine, Shown };
+
+    // the eight neighbours, bit i of a constraint mask is square centre + OFFSETS[i]
+    static constexpr int OFFSETS[8][2] = {{-1,-1}, {-1,0}, {-1,1}, {0,-1}, {0,1}, {1,-1}, {1,0}, {1,1}};
+
+    // layouts of one frontier component counted by how many mines they use
+    struct Layouts
+    {
+        std::vector<int> squares;       // the component's squares
+        std::vector<double> weight;     // layouts with k mines, scaled so the largest is 1
+        std::vector<double> cells;      // layouts with k mines and a mine on square i, at k * squares + i
+        bool exact = true;              // every layout was counted rather than sampled
+        bool found = true;              // at least one layout fits, otherwise the component is left out
+    };
+
+    int rowCount;
+    int columnCount;
+    int mineTotal;
+    std::vector<std::uint8_t> state;        // what is known about each square
+    std::vector<std::uint8_t> unknownMask;  // open squares: neighbours still unknown
+    std::vector<std::int8_t> remaining;     // open squares: mines left among the unknown neighbours
+    std::vector<int> queue;                 // open squares whose constraint changed
+    std::vector<int> active;                // open squares that may still have unknown neighbours
+    std::vector<int> safeFound;             // squares known safe and not opened yet
+    std::vector<int> minesFound;            // squares known to be mines and not opened yet
+    int knownMines = 0;
+    int unknownCount;
+
+    // scratch for probabilities, sized once
+    std::vector<int> frontierSquares;       // unknown squares next to an open number
+    std::vector<int> component;             // frontier squares of one component
+    std::vector<int> slot;                  // square to its place in component, or -1
+    std::vector<int> links;                 // constraints of one component
+    std::vector<std::int8_t> assigned;      // backtracking values
+    std::vector<double> mineWeight;         // per component square
+    std::vector<Layouts> layouts;           // per component of the current hint
+    std::vector<std::vector<double>> before; // mine counts of the components before each one
+    std::vector<std::vector<double>> after;  // and after it
+    std::vector<double> others;             // mine counts of every component but one
+    std::vector<double> outsideWays;        // ways the outside squares hold the rest, by frontier mines
+    std::vector<int> constraintMines;       // backtracking: mines placed per constraint
+    std::vector<int> constraintOpen;        // backtracking: unassigned squares per constraint
+    std::vector<std::vector<int>> cellLinks; // component square to the constraints it is in
+    std::vector<int> seen;                  // frontier squares of the current hint
+    int seenMark = 0;
+    std::vector<int> linkSeen;              // constraints already gathered for the current component
+    int linkMark = 0;
+    long long nodes = 0;
+
+    int index(int rows, int columns) const { return rows * columnCount + columns; }
+
+    bool onBoard(int rows, int columns) const
+    {
+        return rows >= 0 && rows < rowCount && columns >= 0 && columns < columnCount;
+    }
+
+    // a square stops being unknown, every open number next to it loses it from its constraint
+    void resolve(int square, bool mine)
+    {
+        if (state[square] != Unknown)
+            return;
+        state[square] = mine ? Mine : Safe;
+        unknownCount--;
+        if (mine)
+        {
+            knownMines++;
+            minesFound.push_back(square);
+        }
+        else
+            safeFound.push_back(square);
+        int rows = square / columnCount;
+        int columns = square % columnCount;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            int r = rows - OFFSETS[bit][0];
+            int c = columns - OFFSETS[bit][1];
+            if (!onBoard(r, c) || state[index(r, c)] != Open)
+                continue;
+            int number = index(r, c);
+            unknownMask[number] &= static_cast<std::uint8_t>(~(1u << bit));
+            if (mine)
+                remaining[number]--;
+            queue.push_back(number);
+        }
+    }
+
+    void resolveMask(int centre, std::uint8_t mask, bool mine)
+    {
+        int rows = centre / columnCount;
+        int columns = centre % columnCount;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            if (mask & (1u << bit))
+                resolve(index(rows + OFFSETS[bit][0], columns + OFFSETS[bit][1]), mine);
+        }
+    }
+
+    // squares of one constraint, as board indices
+    int squaresOf(int centre, int out[8]) const
+    {
+        int rows = centre / columnCount;
+        int columns = centre % columnCount;
+        int count = 0;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            if (unknownMask[centre] & (1u << bit))
+                out[count++] = index(rows + OFFSETS[bit][0], columns + OFFSETS[bit][1]);
+        }
+        return count;
+    }
+
+    // compare two overlapping constraints: a subset pins down the rest of the bigger one,
+    // and when one has as many extra mines as extra squares those are mines and its partner's extras are safe
+    void comparePair(int first, int second)
+    {
+        int a[8], b[8];
+        int sizeA = squaresOf(first, a);
+        int sizeB = squaresOf(second, b);
+        int onlyA[8], onlyB[8];
+        int countOnlyA = 0, countOnlyB = 0;
+        for (int i = 0; i < sizeA; i++)
+        {
+            bool shared = false;
+            for (int j = 0; j < sizeB; j++)
+                shared = shared || a[i] == b[j];
+            if (!shared)
+                onlyA[countOnlyA++] = a[i];
+        }
+        if (countOnlyA == sizeA)
+            return;     //nothing shared
+        for (int j = 0; j < sizeB; j++)
+        {
+            bool shared = false;
+            for (int i = 0; i < sizeA; i++)
+                shared = shared || a[i] == b[j];
+            if (!shared)
+                onlyB[countOnlyB++] = b[j];
+        }
+        int extra = remaining[first] - remaining[second];   //mines first has beyond second
+        if (extra == countOnlyA)
+        {
+            for (int i = 0; i < countOnlyA; i++)
+                resolve(onlyA[i], true);
+            for (int j = 0; j < countOnlyB; j++)
+                resolve(onlyB[j], false);
+        }
+        else if (-extra == countOnlyB)
+        {
+            for (int j = 0; j < countOnlyB; j++)
+                resolve(onlyB[j], true);
+            for (int i = 0; i < countOnlyA; i++)
+                resolve(onlyA[i], false);
+        }
+    }
+
+    // run the deductions until nothing new follows
+    void propagate()
+    {
+        while (!queue.empty())
+        {
+            int number = queue.back();
+            queue.pop_back();
+            std::uint8_t mask = unknownMask[number];
+            if (mask == 0)
+                continue;
+            int unknown = popcount64(mask);
+            if (remaining[number] == 0)
+            {
+                resolveMask(number, mask, false);
+                continue;
+            }
+            if (remaining[number] == unknown)
+            {
+                resolveMask(number, mask, true);
+                continue;
+            }
+            //numbers up to two squares away can share unknown neighbours
+            int rows = number / columnCount;
+            int columns = number % columnCount;
+            for (int r = rows - 2; r <= rows + 2; r++)
+            {
+                for (int c = columns - 2; c <= columns + 2; c++)
+                {
+                    if ((r == rows && c == columns) || !onBoard(r, c))
+                        continue;
+                    int other = index(r, c);
+                    if (state[other] == Open && unknownMask[other] != 0 && unknownMask[number] != 0)
+                        comparePair(number, other);
+                }
+            }
+        }
+    }
+
+    // drop answers that have been opened since they were found
+    void tidy()
+    {
+        std::size_t keep = 0;
+        for (int square : safeFound)
+        {
+            if (state[square] == Safe)
+                safeFound[keep++] = square;
+        }
+        safeFound.resize(keep);
+        keep = 0;
+        for (int square : minesFound)
+        {
+            if (state[square] == Mine)
+                minesFound[keep++] = square;
+        }
+        minesFound.resize(keep);
+        keep = 0;
+        for (int number : active)
+        {
+            if (unknownMask[number] != 0)
+                active[keep++] = number;
+        }
+        active.resize(keep);
+    }
+
+    // record one layout of the component with the given number of mines,
+    // a sampled layout stands in for weight layouts
+    void countLayout(Layouts& layouts, int mines, double weight = 1)
+    {
+        const std::size_t size = component.size();
+        if (static_cast<int>(layouts.weight.size()) <= mines)
+        {
+            layouts.weight.resize(mines + 1, 0);
+            layouts.cells.resize((mines + 1) * size, 0);
+        }
+        layouts.weight[mines] += weight;
+        for (std::size_t i = 0; i < size; i++)
+            layouts.cells[mines * size + i] += assigned[i] * weight;
+    }
+
+    // go through every layout of the component's mines that fits the numbers;
+    // returns false when there are too many to count within the budget
+    bool enumerate(Layouts& layouts, int position, int mines)
+    {
+        if (++nodes > 20000)
+            return false;
+        if (position == static_cast<int>(component.size()))
+        {
+            countLayout(layouts, mines);
+            return true;
+        }
+        for (int value = 0; value <= 1; value++)
+        {
+            bool fits = true;
+            for (int link : cellLinks[position])
+            {
+                constraintOpen[link]--;
+                constraintMines[link] += value;
+                int need = remaining[links[link]];
+                if (constraintMines[link] > need || constraintMines[link] + constraintOpen[link] < need)
+                    fits = false;
+            }
+            assigned[position] = static_cast<std::int8_t>(value);
+            bool finished = true;
+            if (fits && mines + value <= mineTotal - knownMines)
+                finished = enumerate(layouts, position + 1, mines + value);
+            for (int link : cellLinks[position])
+            {
+                constraintOpen[link]++;
+                constraintMines[link] -= value;
+            }
+            if (!finished)
+                return false;
+        }
+        return true;
+    }
+
+    // natural log of n choose k
+    static double logChoose(int n, int k)
+    {
+        if (k < 0 || k > n)
+            return -INFINITY;
+        return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+    }
+
+    // ways two components' mine counts add up
+    static void combine(const std::vector<double>& first, const std::vector<double>& second, std::vector<double>& out)
+    {
+        out.assign(first.size() + second.size() - 1, 0);
+        for (std::size_t i = 0; i < first.size(); i++)
+        {
+            for (std::size_t j = 0; j < second.size(); j++)
+                out[i + j] += first[i] * second[j];
+        }
+    }
+
+    // count the layouts of the component in component, exactly when the budget allows,
+    // otherwise estimate the counts from random layouts built square by square
+    void countComponent(Layouts& layouts, std::uint64_t& sampleState)
+    {
+        //constraints touching the component
+        links.clear();
+        linkMark++;
+        for (int square : component)
+        {
+            int rows = square / columnCount;
+            int columns = square % columnCount;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                int r = rows - OFFSETS[bit][0];
+                int c = columns - OFFSETS[bit][1];
+                if (!onBoard(r, c))
+                    continue;
+                int number = index(r, c);
+                if (state[number] == Open && (unknownMask[number] & (1u << bit)) && linkSeen[number] != linkMark)
+                {
+                    linkSeen[number] = linkMark;
+                    links.push_back(number);
+                }
+            }
+        }
+        cellLinks.resize(component.size());
+        for (std::vector<int>& cell : cellLinks)
+            cell.clear();
+        constraintMines.assign(links.size(), 0);
+        constraintOpen.assign(links.size(), 0);
+        for (std::size_t link = 0; link < links.size(); link++)
+        {
+            int squares[8];
+            int count = squaresOf(links[link], squares);
+            constraintOpen[link] = count;
+            for (int i = 0; i < count; i++)
+                cellLinks[slot[squares[i]]].push_back(static_cast<int>(link));
+        }
+        assigned.assign(component.size(), 0);
+        layouts.squares = component;
+        layouts.weight.clear();
+        layouts.cells.clear();
+        layouts.exact = true;
+
+        layouts.found = true;
+
+        nodes = 0;
+        if (!enumerate(layouts, 0, 0))
+        {
+            //too many layouts to count, so walk random ones instead: a square either value fits is
+            //picked by a coin flip, and a layout stands in for two to the power of its flips layouts,
+            //which keeps the counts unbiased however unevenly the flips reach the layouts
+            layouts.weight.clear();
+            layouts.cells.clear();
+            layouts.exact = false;
+            double scale = -INFINITY;   //log of the weight the counts are kept against
+            for (int sample = 0; sample < 64; sample++)
+            {
+                std::fill(constraintMines.begin(), constraintMines.end(), 0);
+                for (std::size_t link = 0; link < links.size(); link++)
+                    constraintOpen[link] = popcount64(unknownMask[links[link]]);
+                bool valid = true;
+                int mines = 0;
+                int flips = 0;
+                for (std::size_t position = 0; position < component.size(); position++)
+                {
+                    //a value fits while every constraint of the square can still be met
+                    bool fits[2] = {true, mines < mineTotal - knownMines};
+                    for (int link : cellLinks[position])
+                    {
+                        int need = remaining[links[link]] - constraintMines[link];
+                        int open = constraintOpen[link] - 1;
+                        fits[0] = fits[0] && need <= open;
+                        fits[1] = fits[1] && need >= 1 && need - 1 <= open;
+                    }
+                    int value;
+                    if (fits[0] && fits[1])
+                    {
+                        sampleState = mixBits(sampleState);
+                        value = static_cast<int>(sampleState & 1);
+                        flips++;
+                    }
+                    else if (fits[0] || fits[1])
+                        value = fits[1] ? 1 : 0;
+                    else
+                    {
+                        valid = false;  //a dead end counts as no layouts
+                        break;
+                    }
+                    for (int link : cellLinks[position])
+                    {
+                        constraintOpen[link]--;
+                        constraintMines[link] += value;
+                    }
+                    assigned[position] = static_cast<std::int8_t>(value);
+                    mines += value;
+                }
+                if (!valid)
+                    continue;
+                //weights can pass what a double holds, so keep them against the heaviest sample so far
+                double logWeight = flips * std::log(2.0);
+                if (logWeight > scale)
+                {
+                    double shrink = std::exp(scale - logWeight);
+                    for (double& weight : layouts.weight)
+                        weight *= shrink;
+                    for (double& cell : layouts.cells)
+                        cell *= shrink;
+                    scale = logWeight;
+                }
+                countLayout(layouts, mines, std::exp(logWeight - scale));
+            }
+        }
+        //scale down so multiplying many components together stays in range
+        double largest = 0;
+        for (double weight : layouts.weight)
+            largest = std::max(largest, weight);
+        if (largest > 0)
+        {
+            for (double& weight : layouts.weight)
+                weight /= largest;
+            for (double& cell : layouts.cells)
+                cell /= largest;
+        }
+        //no layout was found, so leave the component out of the product rather than zero every other one
+        if (layouts.weight.empty())
+        {
+            layouts.found = false;
+            layouts.weight.push_back(1);
+            layouts.cells.assign(component.size(), 0);
+        }
+    }
+
+public:
+    Solver(int rowsIn, int columnsIn, int minesIn)
+        : rowCount(rowsIn), columnCount(columnsIn), mineTotal(minesIn)
+    {
+        std::size_t squares = static_cast<std::size_t>(rowsIn) * columnsIn;
+        state.assign(squares, Unknown);
+        unknownMask.assign(squares, 0);
+        remaining.assign(squares, 0);
+        slot.assign(squares, -1);
+        seen.assign(squares, 0);
+        linkSeen.assign(squares, 0);
+        unknownCount = static_cast<int>(squares);
+    }
+
+    // forget everything for a new board of the same size
+    void reset()
+    {
+        std::fill(state.begin(), state.end(), Unknown);
+        std::fill(unknownMask.begin(), unknownMask.end(), 0);
+        std::fill(remaining.begin(), remaining.end(), 0);
+        queue.clear();
+        active.clear();
+        safeFound.clear();
+        minesFound.clear();
+        knownMines = 0;
+        unknownCount = static_cast<int>(state.size());
+    }
+
+    // a square was opened and shows count, its constraint is added and the deductions run from it
+    void opened(int rows, int columns, int count)
+    {
+        int square = index(rows, columns);
+        if (state[square] == Open)
+            return;
+        resolve(square, false);
+        state[square] = Open;
+        std::uint8_t mask = 0;
+        int mines = 0;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            int r = rows + OFFSETS[bit][0];
+            int c = columns + OFFSETS[bit][1];
+            if (!onBoard(r, c))
+                continue;
+            std::uint8_t neighbour = state[index(r, c)];
+            if (neighbour == Unknown)
+                mask |= static_cast<std::uint8_t>(1u << bit);
+            else if (neighbour == Mine || neighbour == Shown)
+                mines++;
+        }
+        unknownMask[square] = mask;
+        remaining[square] = static_cast<std::int8_t>(count - mines);
+        if (mask != 0)
+        {
+            active.push_back(square);
+            queue.push_back(square);
+        }
+        propagate();
+    }
+
+    // a mine was opened, so it is known for certain
+    void revealedMine(int rows, int columns)
+    {
+        int square = index(rows, columns);
+        resolve(square, true);
+        state[square] = Shown;
+        propagate();
+    }
+
+    // tell the solver about squares a click opened
+    void observe(const Board& board, const std::vector<Cell>& changed)
+    {
+        for (const Cell& cell : changed)
+        {
+            if (!board.isOpen(cell.rows, cell.columns))
+                continue;
+            if (board.isMine(cell.rows, cell.columns))
+                revealedMine(cell.rows, cell.columns);
+            else
+                opened(cell.rows, cell.columns, board.mineCount(cell.rows, cell.columns));
+        }
+    }
+
+    bool isKnownMine(int rows, int columns) const { return state[index(rows, columns)] >= Mine; }
+    bool isKnownSafe(int rows, int columns) const { return state[index(rows, columns)] == Safe; }
+
+    // the best next move: a square that is certainly safe if there is one,
+    // otherwise the square least likely to be a mine; wantMine turns it around for demolition,
+    // where the best square to open is a mine
+    std::optional<Hint> hint(std::uint64_t sampleSeed = 1, bool wantMine = false)
+    {
+        tidy();
+        const std::vector<int>& certain = wantMine ? minesFound : safeFound;
+        if (!certain.empty())
+        {
+            int square = certain.back();
+            return Hint{{square / columnCount, square % columnCount}, true, wantMine ? 1.0 : 0.0};
+        }
+        if (unknownCount == 0)
+            return std::nullopt;
+
+        //frontier squares are unknown squares next to an open number, split into linked components
+        frontierSquares.clear();
+        seenMark++;
+        for (int number : active)
+        {
+            int squares[8];
+            int count = squaresOf(number, squares);
+            for (int i = 0; i < count; i++)
+            {
+                if (seen[squares[i]] != seenMark)
+                {
+                    seen[squares[i]] = seenMark;
+                    frontierSquares.push_back(squares[i]);
+                }
+            }
+        }
+        const int outside = unknownCount - static_cast<int>(frontierSquares.size());
+        const int left = mineTotal - knownMines;
+        std::uint64_t sampleState = sampleSeed;
+        std::size_t groups = 0;
+        for (int start : frontierSquares)
+        {
+            if (slot[start] != -1)
+                continue;
+            //gather one component by walking shared constraints
+            component.clear();
+            component.push_back(start);
+            slot[start] = 0;
+            for (std::size_t next = 0; next < component.size(); next++)
+            {
+                int square = component[next];
+                int rows = square / columnCount;
+                int columns = square % columnCount;
+                for (int bit = 0; bit < 8; bit++)
+                {
+                    int r = rows - OFFSETS[bit][0];
+                    int c = columns - OFFSETS[bit][1];
+                    if (!onBoard(r, c) || state[index(r, c)] != Open || !(unknownMask[index(r, c)] & (1u << bit)))
+                        continue;
+                    int squares[8];
+                    int count = squaresOf(index(r, c), squares);
+                    for (int i = 0; i < count; i++)
+                    {
+                        if (slot[squares[i]] == -1)
+                        {
+                            slot[squares[i]] = static_cast<int>(component.size());
+                            component.push_back(squares[i]);
+                        }
+                    }
+                }
+            }
+            if (groups == layouts.size())
+                layouts.emplace_back();
+            countComponent(layouts[groups++], sampleState);
+        }
+        for (int square : frontierSquares)
+            slot[square] = -1;
+
+        //the components share the mines left with the squares away from the numbers, so a component with
+        //k mines is weighted by the ways the others and the outside squares can hold the rest
+        before.resize(groups + 1);
+        after.resize(groups + 1);
+        before[0].assign(1, 1.0);
+        after[groups].assign(1, 1.0);
+        for (std::size_t i = 0; i < groups; i++)
+            combine(before[i], layouts[i].weight, before[i + 1]);
+        for (std::size_t i = groups; i > 0; i--)
+            combine(after[i], layouts[i - 1].weight, after[i - 1]);
+        const std::vector<double>& all = before[groups];
+        outsideWays.assign(all.size(), 0);
+        double largest = -INFINITY;
+        for (std::size_t total = 0; total < all.size(); total++)
+            largest = std::max(largest, logChoose(outside, left - static_cast<int>(total)));
+        for (std::size_t total = 0; total < all.size() && largest > -INFINITY; total++)
+            outsideWays[total] = std::exp(logChoose(outside, left - static_cast<int>(total)) - largest);
+
+        bool allExact = true;
+        std::optional<Hint> best;
+        auto better = [&](double chance) { return !best || (wantMine ? chance > best->probability : chance < best->probability); };
+        auto sure = [&](double chance) { return wantMine ? chance >= 1.0 : chance <= 0.0; };
+        for (std::size_t i = 0; i < groups; i++)
+        {
+            const Layouts& group = layouts[i];
+            allExact = allExact && group.exact && group.found;
+            combine(before[i], after[i + 1], others);
+            const std::size_t size = group.squares.size();
+            double total = 0;
+            mineWeight.assign(size, 0);
+            for (std::size_t k = 0; k < group.weight.size(); k++)
+            {
+                if (group.weight[k] == 0)
+                    continue;
+                double ways = 0;
+                for (std::size_t rest = 0; rest < others.size() && k + rest < outsideWays.size(); rest++)
+                    ways += others[rest] * outsideWays[k + rest];
+                total += group.weight[k] * ways;
+                for (std::size_t square = 0; square < size; square++)
+                    mineWeight[square] += group.cells[k * size + square] * ways;
+            }
+            for (std::size_t square = 0; square < size; square++)
+            {
+                double chance = group.found && total > 0 ? mineWeight[square] / total : 0.5;
+                Cell cell{group.squares[square] / columnCount, group.squares[square] % columnCount};
+                if (better(chance))
+                    best = Hint{cell, group.exact && group.found && total > 0 && sure(chance), chance};
+            }
+        }
+
+        //a square away from the numbers has the average chance of the mines the frontier does not hold
+        if (outside > 0)
+        {
+            double weighted = 0;
+            double total = 0;
+            for (std::size_t mines = 0; mines < all.size(); mines++)
+            {
+                total += all[mines] * outsideWays[mines];
+                weighted += all[mines] * outsideWays[mines] * (left - static_cast<double>(mines));
+            }
+            double chance = total > 0 ? weighted / total / outside : 0.5;
+            if (better(chance))
+            {
+                //prefer a corner, it has the fewest neighbours so it most often opens up an area
+                int pick = -1;
+                for (int square = 0; square < static_cast<int>(state.size()); square++)
+                {
+                    if (state[square] != Unknown || seen[square] == seenMark)
+                        continue;
+                    pick = square;
+                    int rows = square / columnCount, columns = square % columnCount;
+                    if ((rows == 0 || rows == rowCount - 1) && (columns == 0 || columns == columnCount - 1))
+                        break;
+                }
+                if (pick >= 0)
+                    best = Hint{{pick / columnCount, pick % columnCount}, allExact && total > 0 && sure(chance), chance};
+            }
+        }
+        return best;
+    }
+};
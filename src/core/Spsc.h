@@ -0,0 +1,55 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// fixed size queue between exactly one producer thread and one consumer thread, with no locks:
+// each side only ever writes its own index and reads the other's
+template <class T, std::size_t Capacity>
+class SpscQueue
+{
+private:
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "the capacity has to be a power of two");
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    std::array<T, Capacity> slots{};
+    alignas(64) std::atomic<std::size_t> head{0};   // next slot to read, written by the consumer
+    alignas(64) std::atomic<std::size_t> tail{0};   // next slot to write, written by the producer
+
+public:
+    // producer only, false when the queue is full and nothing was added
+    bool push(const T& value)
+    {
+        const std::size_t at = tail.load(std::memory_order_relaxed);
+        if (at - head.load(std::memory_order_acquire) == Capacity)
+            return false;
+        slots[at & MASK] = value;
+        tail.store(at + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only, the oldest value without taking it, nullptr when empty
+    const T* front() const
+    {
+        const std::size_t at = head.load(std::memory_order_relaxed);
+        return at == tail.load(std::memory_order_acquire) ? nullptr : &slots[at & MASK];
+    }
+
+    // consumer only, false when empty
+    bool pop(T& value)
+    {
+        const std::size_t at = head.load(std::memory_order_relaxed);
+        if (at == tail.load(std::memory_order_acquire))
+            return false;
+        value = slots[at & MASK];
+        head.store(at + 1, std::memory_order_release);
+        return true;
+    }
+
+    // producer only, true when a push would fail
+    bool full() const
+    {
+        return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire) == Capacity;
+    }
+};
@@ -0,0 +1,150 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed set of worker threads that split a range of work between them;
+// each worker has its own queue of pieces and takes from the back of it,
+// a worker that runs dry steals from the front of another worker's queue
+class ThreadPool
+{
+private:
+    // a piece of the range, begin inclusive and end exclusive
+    struct Piece
+    {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    // one worker's pieces, only touched by other threads when they steal
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<Piece> pieces;
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<Queue>> queues;     // one per worker
+    std::function<void(int, std::size_t, std::size_t)> job; // runs one piece on a worker
+    std::mutex jobLock;                             // guards job, generation, active and stopping
+    std::condition_variable wake;                   // new work or shutting down
+    std::condition_variable done;                   // the last piece finished or a worker went idle
+    std::atomic<std::size_t> remaining{0};          // pieces not finished yet
+    unsigned long long generation = 0;              // goes up for every parallelFor
+    int active = 0;                                 // workers inside the current job
+    bool stopping = false;
+
+    bool takeOwn(int worker, Piece& piece)
+    {
+        Queue& queue = *queues[worker];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.pieces.empty())
+            return false;
+        piece = queue.pieces.back();
+        queue.pieces.pop_back();
+        return true;
+    }
+
+    bool steal(int worker, Piece& piece)
+    {
+        const int count = static_cast<int>(queues.size());
+        for (int offset = 1; offset < count; offset++)
+        {
+            Queue& queue = *queues[(worker + offset) % count];
+            std::lock_guard<std::mutex> guard(queue.lock);
+            if (queue.pieces.empty())
+                continue;
+            piece = queue.pieces.front();
+            queue.pieces.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void run(int worker)
+    {
+        unsigned long long seen = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> guard(jobLock);
+                wake.wait(guard, [&] { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+                active++;
+            }
+            Piece piece;
+            while (takeOwn(worker, piece) || steal(worker, piece))
+            {
+                job(worker, piece.begin, piece.end);
+                remaining.fetch_sub(1, std::memory_order_acq_rel);
+            }
+            {
+                std::lock_guard<std::mutex> guard(jobLock);
+                active--;
+            }
+            done.notify_all();
+        }
+    }
+
+public:
+    explicit ThreadPool(int count = static_cast<int>(std::thread::hardware_concurrency()))
+    {
+        count = std::max(count, 1);
+        for (int i = 0; i < count; i++)
+            queues.push_back(std::make_unique<Queue>());
+        for (int i = 0; i < count; i++)
+            threads.emplace_back([this, i] { run(i); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(jobLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(threads.size()); }
+
+    // run fn(worker, begin, end) over [0, count) in pieces of about grain items and wait for all of it;
+    // worker is 0 to size()-1, so per worker buffers can be set up before the call
+    template <class Fn>
+    void parallelFor(std::size_t count, std::size_t grain, Fn fn)
+    {
+        if (count == 0)
+            return;
+        grain = std::max<std::size_t>(grain, 1);
+        std::unique_lock<std::mutex> guard(jobLock);
+        //a worker that woke late for the last job may still be looking for pieces
+        done.wait(guard, [&] { return active == 0; });
+        job = fn;
+        //deal the pieces out in runs so each worker starts on its own part of the range
+        const std::size_t pieces = (count + grain - 1) / grain;
+        const std::size_t perWorker = (pieces + queues.size() - 1) / queues.size();
+        for (std::size_t piece = 0; piece < pieces; piece++)
+        {
+            Queue& queue = *queues[piece / perWorker];
+            std::lock_guard<std::mutex> queueGuard(queue.lock);
+            queue.pieces.push_back({piece * grain, std::min(count, (piece + 1) * grain)});
+        }
+        remaining.store(pieces, std::memory_order_release);
+        generation++;
+        wake.notify_all();
+        done.wait(guard, [&] { return remaining.load(std::memory_order_acquire) == 0 && active == 0; });
+    }
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// hands the newest of a stream of values from one writer thread to one reader thread without locks
+// or waiting: the writer fills its own slot and swaps it for the middle one, the reader swaps its
+// own slot for the middle one when that is newer; values the reader never got to are skipped
+template <class T>
+class TripleBuffer
+{
+private:
+    static constexpr std::uint8_t INDEX = 3;    // slot index bits of middle
+    static constexpr std::uint8_t FRESH = 4;    // the middle slot holds a value the reader has not taken
+
+    std::array<T, 3> slots;
+    std::atomic<std::uint8_t> middle{1};
+    std::uint8_t back = 0;      // the writer's slot
+    std::uint8_t front = 2;     // the reader's slot
+
+public:
+    explicit TripleBuffer(const T& initial) : slots{initial, initial, initial} {}
+
+    // writer only, the slot to fill; it holds whatever was published two or more times ago
+    T& writing() { return slots[back]; }
+
+    // writer only, make the filled slot the newest value
+    void publish()
+    {
+        back = middle.exchange(static_cast<std::uint8_t>(back | FRESH), std::memory_order_acq_rel) & INDEX;
+    }
+
+    // reader only, take the newest value if there is one; true when reading() changed
+    bool update()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH))
+            return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    // reader only, the value taken last
+    const T& reading() const { return slots[front]; }
+};
@@ -8,9 +8,173 @@
 #include "Demolition.h"
 #include "Title.h"
 #include "Difficulty.h"
+#include "Assets.h"
+#include "Audio.h"
+#include "Hud.h"
+#include "Lobby.h"
+#include "Profiler.h"
+#include "Race.h"
+#include "core/Archive.h"
+#include "core/Mines.h"
+#include "core/Replay.h"
+#include "Scene.h"
 #include <string>
 #include <sstream>
-int main()
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <new>
+
+// every allocation the game makes is counted for the profiler's overlay, by the thread making it
+void* operator new(std::size_t size)
 {
-    title();
+    allocationCount++;
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+// the board a replay was recorded on, one of the game's own boards
+std::optional<BoardConfig> replayBoard(const ReplayHeader& header)
+{
+    for (const BoardConfig& config : {easyBoard(), mediumBoard(), hardBoard(), largeBoard(), demolitionBoard()})
+    {
+        if (config.mode == header.mode && config.rows == header.rows && config.columns == header.columns && config.mines == header.mines)
+            return config;
+    }
+    return std::nullopt;
+}
+
+// open a race's board once its server has started it
+void playRace(SceneManager& scenes, std::unique_ptr<RaceLink> link)
+{
+    std::optional<BoardConfig> config = replayBoard(link->race().header());
+    if (config)
+        scenes.change<BoardScene>(*config, std::nullopt, SIZE_MAX, std::move(link));
+    else
+    {
+        std::cerr << "the race is on a board this game does not have" << std::endl;
+        title(scenes);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    //--seed N plays every board from the same seed, --profile file writes frame timings (.json for a Chrome trace, else CSV),
+    //--record folder keeps every board played as a replay, --replay file opens one at its end or after --move N moves,
+    //--host port [--race easy|medium|hard|large] serves a two player race and plays in it, --join address port plays in one
+    std::string replayPath;
+    std::size_t replayMoves = SIZE_MAX;
+    std::string raceAddress;
+    unsigned short racePort = 0;
+    bool hosting = false;
+    BoardConfig raceConfig = largeBoard();
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::string(argv[i]) == "--seed")
+            Seeds::setFixed(std::stoull(argv[i + 1]));
+        else if (std::string(argv[i]) == "--profile" && !Profiler::writeTo(argv[i + 1]))
+            std::cerr << "cannot write " << argv[i + 1] << std::endl;
+        else if (std::string(argv[i]) == "--record")
+        {
+            std::error_code error;
+            std::filesystem::create_directories(argv[i + 1], error);
+            replayFolder() = argv[i + 1];
+        }
+        else if (std::string(argv[i]) == "--replay")
+            replayPath = argv[i + 1];
+        else if (std::string(argv[i]) == "--move")
+            replayMoves = std::stoull(argv[i + 1]);
+        else if (std::string(argv[i]) == "--host")
+        {
+            hosting = true;
+            raceAddress = "127.0.0.1";
+            racePort = static_cast<unsigned short>(std::stoul(argv[i + 1]));
+        }
+        else if (std::string(argv[i]) == "--join" && i + 2 < argc)
+        {
+            raceAddress = argv[i + 1];
+            racePort = static_cast<unsigned short>(std::stoul(argv[i + 2]));
+        }
+        else if (std::string(argv[i]) == "--race")
+        {
+            const std::string name = argv[i + 1];
+            if (name == "easy")
+                raceConfig = easyBoard();
+            else if (name == "medium")
+                raceConfig = mediumBoard();
+            else if (name == "hard")
+                raceConfig = hardBoard();
+            else if (name == "large")
+                raceConfig = largeBoard();
+            else
+            {
+                std::cerr << "usage: minesweeper [--seed N] [--profile file] [--record folder] [--replay file [--move N]]\n"
+                             "                   [--host port [--race easy|medium|hard|large]] [--join address port]\n";
+                return 2;
+            }
+        }
+    }
+    //connected before the window opens, the lobby screen then waits for the race to start;
+    //the host's server belongs to its player's link and stops when that player leaves the race
+    std::unique_ptr<RaceHost> host;
+    std::unique_ptr<RaceLink> link;
+    if (hosting)
+    {
+        host = std::make_unique<RaceHost>(racePort, ReplayHeader{raceConfig.mode, raceConfig.rows, raceConfig.columns, raceConfig.mines, Seeds::next()}, 2);
+        if (!host->ok())
+            std::cerr << "cannot listen on port " << racePort << std::endl;
+        else
+            std::cout << "waiting for the other player on port " << racePort << std::endl;
+    }
+    if (!raceAddress.empty() && (!host || host->ok()))
+    {
+        link = std::make_unique<RaceLink>(std::move(host));
+        if (!link->connect(raceAddress, racePort))
+        {
+            std::cerr << "cannot join the race at " << raceAddress << ":" << racePort << std::endl;
+            link.reset();
+        }
+    }
+    //every asset comes out of the archive next to the game, found from its own path rather than the working folder
+    const std::filesystem::path archive = std::filesystem::path(argv[0]).parent_path() / ARCHIVE_NAME;
+    if (!Assets::mount(archive.string()))
+        std::cerr << "no asset archive at " << archive.string() << ", reading loose files" << std::endl;
+    //the sound and the title screen decode in the background while the window opens
+    Audio::prefetch();
+    Assets::prefetch("Minesweeper_title_screen_new.png");
+    //one window for the whole game, scenes are swapped on it instead of opening new windows
+    sf :: RenderWindow window(sf :: VideoMode({1920,1080}), "MINESWEEPER", sf :: State :: Fullscreen);
+    window.setFramerateLimit(60);
+    //sounds are decoded before the first click so an explosion never waits on the disk
+    Audio::preload();
+    Profiler::setFont(hudFont());
+    SceneManager scenes(window);
+    title(scenes);
+    if (!replayPath.empty())
+    {
+        //the scene plays the moves while it is made, so the file is only needed until then
+        MappedFile file;
+        std::optional<ReplayReader> replay;
+        if (file.open(replayPath))
+            replay.emplace(file.data(), file.size());
+        std::optional<BoardConfig> config = replay && replay->valid() ? replayBoard(replay->header()) : std::nullopt;
+        if (config)
+            scenes.change<BoardScene>(*config, replay, replayMoves);
+        else
+            std::cerr << "cannot play " << replayPath << ", it is not a replay of one of the boards" << std::endl;
+    }
+    if (link)
+        scenes.change<LobbyScene>(scenes, std::move(link), playRace);
+    scenes.run();
 }
@@ -0,0 +1,439 @@
+// times the hot paths of the game so performance work can be compared across commits
+//
+// bench [--filter text] [--min-time seconds] [--json file]
+//
+// every benchmark is run until it has taken at least --min-time, five times over,
+// and the median time per operation is reported; --json writes the same results as
+// {"benchmarks": [{"name", "ns_per_op", "iterations", "items_per_op"}]} for diffing.
+// the core benchmarks need nothing else, the effects, hit test and render ones are built
+// when the game is (MINESWEEPER_BENCH_GAME) and load the images from the archive next to it like the game
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+#include "../core/Board.h"
+#include "../core/ChunkedBoard.h"
+#include "../core/Flood.h"
+#include "../core/Mines.h"
+#include "../core/Preset.h"
+#include "../core/Simulation.h"
+#include "../core/Solver.h"
+#ifdef MINESWEEPER_BENCH_GAME
+#include "../BoardRenderer.h"
+#include "../Effects.h"
+#include "../HitTest.h"
+#endif
+
+namespace
+{
+volatile unsigned char sink;
+
+// reads a value through a volatile so the work making it is not optimised away
+template <class T>
+void keep(const T& value)
+{
+    sink = *reinterpret_cast<const volatile unsigned char*>(&value);
+}
+
+// the shipped boards with their own numbers, and one far bigger than any of them
+const std::vector<PresetInfo> PRESETS = []
+{
+    std::vector<PresetInfo> presets = shippedPresets();
+    presets.push_back({"huge", 500, 500, 50000, GameMode::Classic, {}, nullptr});
+    return presets;
+}();
+
+struct Result
+{
+    std::string name;
+    double nsPerOp;
+    long long iterations;
+    double itemsPerOp;  // squares, particles or similar handled by one operation, 0 when it does not apply
+};
+
+// runs benchmarks and keeps their results, a benchmark body gets how many operations to run
+class Harness
+{
+private:
+    std::string filter;
+    double minTime;
+    std::vector<Result> results;
+
+    static double time(const std::function<void(long long)>& body, long long iterations)
+    {
+        auto start = std::chrono::steady_clock::now();
+        body(iterations);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+public:
+    Harness(std::string filterIn, double minTimeIn) : filter(std::move(filterIn)), minTime(minTimeIn) {}
+
+    void run(const std::string& name, double itemsPerOp, const std::function<void(long long)>& body)
+    {
+        if (!filter.empty() && name.find(filter) == std::string::npos)
+            return;
+        //double the count until a run is long enough to measure, then size it for the minimum time
+        long long iterations = 1;
+        double seconds = time(body, iterations);
+        while (seconds < minTime / 20 && iterations < (1LL << 40))
+        {
+            iterations *= 2;
+            seconds = time(body, iterations);
+        }
+        iterations = std::max(1LL, static_cast<long long>(static_cast<double>(iterations) * minTime / std::max(seconds, 1e-9)));
+        std::vector<double> perOp;
+        for (int repeat = 0; repeat < 5; repeat++)
+            perOp.push_back(time(body, iterations) * 1e9 / static_cast<double>(iterations));
+        std::sort(perOp.begin(), perOp.end());
+        results.push_back({name, perOp[2], iterations, itemsPerOp});
+        std::cout << std::left << std::setw(44) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << perOp[2] << " ns/op" << std::setw(14) << iterations << " iterations\n";
+    }
+
+    bool writeJson(const std::string& path) const
+    {
+        std::ofstream file(path);
+        if (!file)
+            return false;
+        file << "{\n  \"benchmarks\": [\n";
+        for (std::size_t i = 0; i < results.size(); i++)
+        {
+            const Result& result = results[i];
+            file << "    {\"name\": \"" << result.name << "\", \"ns_per_op\": " << std::setprecision(3) << std::fixed
+                 << result.nsPerOp << ", \"iterations\": " << result.iterations << ", \"items_per_op\": "
+                 << result.itemsPerOp << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        file << "  ]\n}\n";
+        return true;
+    }
+};
+
+// the square whose click opens the biggest empty area on the board, for timing the biggest flood from
+// one click; each area is flooded once from its first empty square. A board with no empty square gives
+// its first safe one
+Cell openingOf(const Board& board)
+{
+    FloodFill flood(board.rows() * board.columns());
+    BitPlane covered(board.rows(), board.columns());
+    std::optional<Cell> best;
+    std::size_t bestSize = 0;
+    for (int rows = 0; rows < board.rows(); rows++)
+    {
+        for (int columns = 0; columns < board.columns(); columns++)
+        {
+            if (board.isMine(rows, columns))
+                continue;
+            if (!best)
+                best = Cell{rows, columns};
+            if (board.mineCount(rows, columns) != 0 || covered.test(rows, columns))
+                continue;
+            const std::size_t size = flood.reveal(board.minePlane(), board.counts(), covered, rows, columns, 0).cells.size();
+            if (size > bestSize)
+            {
+                best = Cell{rows, columns};
+                bestSize = size;
+            }
+        }
+    }
+    return best.value_or(Cell{0, 0});
+}
+
+// the clicks that win a board opened in square order: every safe square, or in demolition every mine;
+// the last one is the click that ends the game
+std::vector<Cell> winningClicks(Board& board)
+{
+    std::vector<Cell> clicks;
+    const bool demolition = board.rules() == GameMode::Demolition;
+    for (int rows = 0; rows < board.rows() && !board.finished(); rows++)
+    {
+        for (int columns = 0; columns < board.columns() && !board.finished(); columns++)
+        {
+            if (board.isMine(rows, columns) == demolition && !board.isOpen(rows, columns) && board.open(rows, columns).accepted)
+                clicks.push_back({rows, columns});
+        }
+    }
+    return clicks;
+}
+
+void coreBenchmarks(Harness& harness)
+{
+    for (const PresetInfo& preset : PRESETS)
+    {
+        const double squares = static_cast<double>(preset.rows) * preset.columns;
+
+        //counting neighbours of every square, the replacement for countMines
+        BitPlane mines(preset.rows, preset.columns);
+        placeMines(mines, preset.mines, 1);
+        MineCounts counts(preset.rows, preset.columns);
+        harness.run("mine_counts/" + preset.name, squares, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                counts.build(mines);
+                keep(counts.at(0, 0));
+            }
+        });
+
+        harness.run("place_mines/" + preset.name, preset.mines, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                mines.clear();
+                placeMines(mines, preset.mines, static_cast<std::uint64_t>(i));
+                keep(mines.row(0)[0]);
+            }
+        });
+
+        //one click opening an empty area, the replacement for floodScore and floodDemolition
+        Board board(preset.rows, preset.columns, preset.mines, preset.mode);
+        board.generate(1);
+        const Cell opening = openingOf(board);
+        FloodFill flood(preset.rows * preset.columns);
+        BitPlane selected(preset.rows, preset.columns);
+        std::size_t opened = flood.reveal(board.minePlane(), board.counts(), selected, opening.rows, opening.columns, 100).cells.size();
+        harness.run("flood/" + preset.name, static_cast<double>(opened), [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                selected.clear();
+                keep(flood.reveal(board.minePlane(), board.counts(), selected, opening.rows, opening.columns, 100).score);
+            }
+        });
+
+        //the click that ends a game, on a copy of a board one click from the end; the copy alone is timed
+        //too so the win and loss checks are what is left after taking it away
+        board.generate(1);
+        const std::vector<Cell> clicks = winningClicks(board);
+        board.generate(1);
+        for (std::size_t click = 0; click + 1 < clicks.size(); click++)
+            board.open(clicks[click].rows, clicks[click].columns);
+        const Board nearlyWon = board;
+        const Cell winning = clicks.back();
+        Board ending = nearlyWon;
+        harness.run("game_end/copy/" + preset.name, squares, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                ending = nearlyWon;
+                keep(ending.state());
+            }
+        });
+        harness.run("game_end/win/" + preset.name, 1, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                ending = nearlyWon;
+                keep(ending.open(winning.rows, winning.columns).ended);
+            }
+        });
+        //a classic board is lost by any mine, a demolition one only once its lives are gone
+        if (preset.mode == GameMode::Classic)
+        {
+            Cell mine{0, 0};
+            while (!nearlyWon.isMine(mine.rows, mine.columns))
+                mine = mine.columns + 1 < preset.columns ? Cell{mine.rows, mine.columns + 1} : Cell{mine.rows + 1, 0};
+            harness.run("game_end/loss/" + preset.name, 1, [&](long long iterations)
+            {
+                for (long long i = 0; i < iterations; i++)
+                {
+                    ending = nearlyWon;
+                    keep(ending.open(mine.rows, mine.columns).ended);
+                }
+            });
+        }
+
+        //whole games of random clicks, every click runs the rules and the win and loss checks
+        std::vector<int> order(static_cast<std::size_t>(squares));
+        for (std::size_t i = 0; i < order.size(); i++)
+            order[i] = static_cast<int>(i);
+        harness.run("random_game/" + preset.name, 0, [&](long long iterations)
+        {
+            std::uint64_t state = 7;
+            for (long long i = 0; i < iterations; i++)
+            {
+                board.generate(static_cast<std::uint64_t>(i));
+                for (std::size_t next = 0; next < order.size() && !board.finished(); next++)
+                {
+                    state = mixBits(state);
+                    std::swap(order[next], order[next + state % (order.size() - next)]);
+                    board.open(order[next] / preset.columns, order[next] % preset.columns);
+                }
+                keep(board.state());
+            }
+        });
+
+        //the solver playing whole games, its hints are the in-game hint key
+        if (preset.rows * preset.columns <= 900)
+        {
+            Solver solver(preset.rows, preset.columns, preset.mines);
+            const bool wantMine = preset.mode == GameMode::Demolition;
+            harness.run("solver_game/" + preset.name, 0, [&](long long iterations)
+            {
+                for (long long i = 0; i < iterations; i++)
+                {
+                    board.generate(static_cast<std::uint64_t>(i));
+                    solver.reset();
+                    while (!board.finished())
+                    {
+                        std::optional<Hint> hint = solver.hint(1, wantMine);
+                        if (!hint)
+                            break;
+                        solver.observe(board, board.open(hint->cell.rows, hint->cell.columns).changed);
+                    }
+                    keep(board.state());
+                }
+            });
+        }
+    }
+
+    //the endless board: building chunks and spreading a flood over them
+    harness.run("endless/open_and_spread", 0, [&](long long iterations)
+    {
+        for (long long i = 0; i < iterations; i++)
+        {
+            ChunkedBoard endless(static_cast<std::uint64_t>(i), 0.16);
+            endless.open(0, 0);
+            while (endless.spreading())
+                keep(endless.spread(4096).size());
+            keep(endless.loadedChunks());
+        }
+    });
+
+    //a flag sent to the rules thread until the snapshot showing it is back, the part of click to present
+    //the simulation adds; each send here lands just after a step so this is the worst case of one whole
+    //step, a click at a random time waits half of one
+    harness.run("simulation/command_round_trip", 1, [&](long long iterations)
+    {
+        BoardSimulation sim(HardPreset::rows, HardPreset::columns, HardPreset::mines, HardPreset::mode);
+        sim.withBoard([](Board& board, Solver&) { board.generate(1); });
+        sim.start();
+        SimEvent event;
+        for (long long i = 0; i < iterations; i++)
+        {
+            sim.send({SimAction::Flag, {static_cast<int>(i % HardPreset::rows), 0}, 0, std::chrono::steady_clock::now()});
+            while (sim.waiting())
+                sim.refresh();
+            while (sim.nextEvent(event))
+                keep(event.accepted);
+        }
+    });
+}
+
+#ifdef MINESWEEPER_BENCH_GAME
+void gameBenchmarks(Harness& harness, const std::string& program)
+{
+    Assets::mount((std::filesystem::path(program).parent_path() / ARCHIVE_NAME).string());
+
+    //every square of the hard board's screen area in turn
+    harness.run("hit_test/cell_at", 1, [&](long long iterations)
+    {
+        int x = 0;
+        for (long long i = 0; i < iterations; i++)
+        {
+            x = (x + 7) % 1920;
+            keep(cellAt({x, static_cast<int>(i % 1080)}, {HardPreset::originX, HardPreset::originY}, HardPreset::cellSize, HardPreset::rows, HardPreset::columns));
+        }
+    });
+
+    //the same pixels through the hard preset's compile time tables
+    harness.run("hit_test/preset_table", 1, [&](long long iterations)
+    {
+        int x = 0;
+        for (long long i = 0; i < iterations; i++)
+        {
+            x = (x + 7) % 1920;
+            keep(cellAt({x, static_cast<int>(i % 1080)}, HardPreset::layout));
+        }
+    });
+
+    //a demolition chain reaction's worth of effects, spawned and run to the end
+    harness.run("effects/spawn_update_churn", 100 * 600, [&](long long iterations)
+    {
+        Effects effects;
+        for (long long i = 0; i < iterations; i++)
+        {
+            for (int burst = 0; burst < 100; burst++)
+            {
+                effects.spawn<RingWaveEffect>(sf::Vector2f{960.f, 540.f}, 0.f, 600.f, 0.1f, sf::Color(255,80,30));
+                effects.spawn<ParticleBurst>(sf::Vector2f{960.f, 540.f}, 600, sf::Color(120,70,40));
+            }
+            for (int frame = 0; frame < 120 && effects.size() > 0; frame++)
+                effects.update(1.f / 60.f);
+            keep(effects.size());
+        }
+    });
+
+    //drawing each preset's board offscreen, once with every tile changed and once unchanged
+    sf::RenderWindow window(sf::VideoMode({1920, 1080}), "bench", sf::State::Windowed);
+    for (const PresetInfo& preset : shippedPresets())
+    {
+        const BoardLayout& layout = *preset.layout;
+        BoardRenderer renderer(preset.screen.background, preset.screen.skin, preset.rows, preset.columns,
+                               {static_cast<float>(layout.originX), static_cast<float>(layout.originY)}, static_cast<float>(layout.cellSize));
+        harness.run(std::string("render/changed/") + preset.name, preset.rows * preset.columns, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                const Tile tile = i % 2 ? Tile::Cover : Tile::Empty;
+                for (int rows = 0; rows < preset.rows; rows++)
+                {
+                    for (int columns = 0; columns < preset.columns; columns++)
+                        renderer.setTile(rows, columns, tile);
+                }
+                renderer.draw(window);
+                window.display();
+            }
+        });
+        harness.run(std::string("render/unchanged/") + preset.name, preset.rows * preset.columns, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                renderer.draw(window);
+                window.display();
+            }
+        });
+    }
+}
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+    std::string filter;
+    std::string json;
+    double minTime = 0.2;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string name = argv[i];
+        if (name == "--filter")
+            filter = argv[i + 1];
+        else if (name == "--min-time")
+            minTime = std::stod(argv[i + 1]);
+        else if (name == "--json")
+            json = argv[i + 1];
+        else
+        {
+            std::cerr << "usage: bench [--filter text] [--min-time seconds] [--json file]\n";
+            return 2;
+        }
+    }
+    Harness harness(filter, minTime);
+    coreBenchmarks(harness);
+#ifdef MINESWEEPER_BENCH_GAME
+    gameBenchmarks(harness, argv[0]);
+#endif
+    if (!json.empty() && !harness.writeJson(json))
+    {
+        std::cerr << "cannot write " << json << "\n";
+        return 1;
+    }
+    return 0;
+}
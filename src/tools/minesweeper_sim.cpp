@@ -0,0 +1,426 @@
+// plays minesweeper games against the core rules with no window, as fast as the machine allows
+//
+// minesweeper_sim [--preset easy|medium|hard|demolition|large] [--rows N] [--columns N] [--mines N]
+//                 [--mode classic|demolition] [--games N] [--seed N] [--script file]
+//                 [--threads N] [--batch] [--player random|solver]
+// minesweeper_sim --replays folder [--threads N]
+//
+// without a script every game is played by clicking random squares that are not open yet,
+// or with --player solver by opening whatever the solver's hint says;
+// a script has one move per line, "open r c" or "flag r c", and is played on every game.
+// games are shared out over a work stealing pool, --batch plays every preset in turn;
+// game n always uses the same board and clicks, so results do not depend on the thread count.
+// --replays plays back every .msr file the game recorded into a folder and adds up how those games went
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../core/Archive.h"
+#include "../core/Board.h"
+#include "../core/Preset.h"
+#include "../core/Replay.h"
+#include "../core/Solver.h"
+#include "../core/ThreadPool.h"
+
+namespace
+{
+// one move of a scripted game
+struct Move
+{
+    bool flag;
+    int rows;
+    int columns;
+};
+
+struct Options
+{
+    PresetInfo preset = shippedPresets()[0];
+    long long games = 1000000;
+    std::uint64_t seed = 1;
+    std::string script;
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    bool batch = false;
+    bool solver = false;    // the solver plays instead of random clicks
+    std::string replays;    // folder of recorded games to play back instead
+};
+
+// totals kept by one worker, on its own cache line so workers never write to the same one
+struct alignas(64) Stats
+{
+    long long games = 0;
+    long long won = 0;
+    long long lost = 0;
+    long long clicks = 0;
+    long long totalScore = 0;
+    std::vector<long long> scores;  // games per 100 points of score
+    long long lives[6] = {};        // demolition games by lives left, 5 or more in the last slot
+
+    void add(const Stats& other)
+    {
+        games += other.games;
+        won += other.won;
+        lost += other.lost;
+        clicks += other.clicks;
+        totalScore += other.totalScore;
+        if (scores.size() < other.scores.size())
+            scores.resize(other.scores.size(), 0);
+        for (std::size_t i = 0; i < other.scores.size(); i++)
+            scores[i] += other.scores[i];
+        for (int i = 0; i < 6; i++)
+            lives[i] += other.lives[i];
+    }
+
+    // lowest score that at least part of the games reached or beat
+    long long percentile(double part) const
+    {
+        long long wanted = static_cast<long long>(part * static_cast<double>(games));
+        long long seen = 0;
+        for (std::size_t i = 0; i < scores.size(); i++)
+        {
+            seen += scores[i];
+            if (seen > wanted)
+                return static_cast<long long>(i) * 100;
+        }
+        return static_cast<long long>(scores.size()) * 100;
+    }
+};
+
+// buffers one worker plays its games with, made once before the games start
+struct Worker
+{
+    Board board;
+    Solver solver;
+    std::vector<int> order;     // squares in the order random clicks try them
+    std::vector<int> swaps;     // swaps made on order by the last game, undone so every game starts the same
+    Stats stats;
+
+    explicit Worker(const PresetInfo& preset)
+        : board(preset.rows, preset.columns, preset.mines, preset.mode),
+          solver(preset.rows, preset.columns, preset.mines),
+          order(static_cast<std::size_t>(preset.rows) * preset.columns)
+    {
+        swaps.reserve(order.size());
+        for (std::size_t i = 0; i < order.size(); i++)
+            order[i] = static_cast<int>(i);
+        //highest score is every safe square at 100 plus every mine at 500
+        stats.scores.assign(order.size() + preset.mines * 5 + 1, 0);
+    }
+};
+
+bool readScript(const std::string& path, std::vector<Move>& moves)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream words(line);
+        std::string action;
+        Move move{};
+        if (!(words >> action >> move.rows >> move.columns))
+            continue;   //blank lines and comments
+        move.flag = action == "flag";
+        moves.push_back(move);
+    }
+    return true;
+}
+
+bool parse(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string name = argv[i];
+        if (name == "--batch")
+        {
+            options.batch = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            return false;
+        std::string value = argv[++i];
+        if (name == "--preset")
+        {
+            const std::vector<PresetInfo>& presets = shippedPresets();
+            auto found = std::find_if(presets.begin(), presets.end(), [&](const PresetInfo& preset) { return preset.name == value; });
+            if (found == presets.end())
+                return false;
+            options.preset = *found;
+        }
+        else if (name == "--rows")
+            options.preset.rows = std::stoi(value), options.preset.name = "custom";
+        else if (name == "--columns")
+            options.preset.columns = std::stoi(value), options.preset.name = "custom";
+        else if (name == "--mines")
+            options.preset.mines = std::stoi(value), options.preset.name = "custom";
+        else if (name == "--mode")
+            options.preset.mode = value == "demolition" ? GameMode::Demolition : GameMode::Classic;
+        else if (name == "--games")
+            options.games = std::stoll(value);
+        else if (name == "--seed")
+            options.seed = std::stoull(value);
+        else if (name == "--script")
+            options.script = value;
+        else if (name == "--replays")
+            options.replays = value;
+        else if (name == "--threads")
+            options.threads = std::stoi(value);
+        else if (name == "--player")
+        {
+            if (value != "random" && value != "solver")
+                return false;
+            options.solver = value == "solver";
+        }
+        else
+            return false;
+    }
+    return options.preset.rows > 0 && options.preset.columns > 0 && options.preset.mines >= 0 && options.games > 0;
+}
+// play one game on a worker's board, random clicks are drawn from a stream seeded by the game
+void playGame(Worker& worker, const PresetInfo& preset, std::uint64_t gameSeed, const std::vector<Move>& moves, bool useSolver)
+{
+    Board& board = worker.board;
+    Stats& stats = worker.stats;
+    board.generate(gameSeed);
+    if (!moves.empty())
+    {
+        for (const Move& move : moves)
+        {
+            if (board.finished())
+                break;
+            if (move.rows < 0 || move.rows >= preset.rows || move.columns < 0 || move.columns >= preset.columns)
+                continue;
+            if (move.flag)
+                board.toggleFlag(move.rows, move.columns);
+            else
+                board.open(move.rows, move.columns);
+            stats.clicks++;
+        }
+    }
+    else if (useSolver)
+    {
+        //open the hinted square until the game ends, the hint's own guesses are seeded by the game too
+        Solver& solver = worker.solver;
+        solver.reset();
+        while (!board.finished())
+        {
+            std::optional<Hint> hint = solver.hint(gameSeed, preset.mode == GameMode::Demolition);
+            if (!hint)
+                break;
+            const ClickResult& opened = board.open(hint->cell.rows, hint->cell.columns);
+            solver.observe(board, opened.changed);
+            stats.clicks++;
+        }
+    }
+    else
+    {
+        //random clicks in a fresh shuffled order, a partial shuffle only pays for the squares used
+        std::vector<int>& order = worker.order;
+        const int squares = static_cast<int>(order.size());
+        std::uint64_t clickState = gameSeed ^ 0xC2B2AE3D27D4EB4FULL;
+        worker.swaps.clear();
+        for (int next = 0; next < squares && !board.finished(); next++)
+        {
+            clickState = mixBits(clickState);
+            int other = next + static_cast<int>(clickState % static_cast<std::uint64_t>(squares - next));
+            std::swap(order[next], order[other]);
+            worker.swaps.push_back(other);
+            int rows = order[next] / preset.columns;
+            int columns = order[next] % preset.columns;
+            if (board.isOpen(rows, columns))
+                continue;
+            board.open(rows, columns);
+            stats.clicks++;
+        }
+        //put the order back, so the clicks only depend on the game's seed and not on the worker
+        for (int next = static_cast<int>(worker.swaps.size()) - 1; next >= 0; next--)
+            std::swap(order[next], order[worker.swaps[next]]);
+    }
+    stats.games++;
+    if (board.state() == 2)
+        stats.won++;
+    else if (board.state() == 1)
+        stats.lost++;
+    stats.totalScore += board.score();
+    stats.scores[std::min<std::size_t>(board.score() / 100, stats.scores.size() - 1)]++;
+    if (preset.mode == GameMode::Demolition)
+        stats.lives[std::clamp(board.lives(), 0, 5)]++;
+}
+
+// play every game of one preset over the pool and add up what the workers saw
+Stats simulate(const Options& options, const PresetInfo& preset, const std::vector<Move>& moves, ThreadPool& pool)
+{
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < pool.size(); i++)
+        workers.push_back(std::make_unique<Worker>(preset));
+    pool.parallelFor(static_cast<std::size_t>(options.games), 1024, [&](int worker, std::size_t begin, std::size_t end)
+    {
+        for (std::size_t game = begin; game < end; game++)
+            playGame(*workers[worker], preset, mixBits(options.seed + game), moves, options.solver);
+    });
+    //every worker is finished, so the totals can be read without locking
+    Stats total;
+    for (const std::unique_ptr<Worker>& worker : workers)
+        total.add(worker->stats);
+    return total;
+}
+
+// totals of the replays one worker played back
+struct alignas(64) ReplayStats
+{
+    long long replays = 0;
+    long long unreadable = 0;   // missing, not a replay or with a broken header
+    long long won = 0;
+    long long lost = 0;
+    long long moves = 0;
+    long long totalScore = 0;
+    std::uint64_t milliseconds = 0;
+};
+
+// play back every replay in a folder through the rules, each file is mapped rather than read
+int analyseReplays(const std::string& folder, ThreadPool& pool)
+{
+    std::vector<std::string> paths;
+    std::error_code error;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(folder, error))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".msr")
+            paths.push_back(entry.path().string());
+    }
+    if (error)
+    {
+        std::cerr << "cannot read " << folder << ": " << error.message() << "\n";
+        return 1;
+    }
+    std::sort(paths.begin(), paths.end());
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<ReplayStats> stats(static_cast<std::size_t>(pool.size()));
+    std::vector<std::unique_ptr<Board>> boards(static_cast<std::size_t>(pool.size()));
+    pool.parallelFor(paths.size(), 16, [&](int worker, std::size_t begin, std::size_t end)
+    {
+        ReplayStats& tally = stats[static_cast<std::size_t>(worker)];
+        std::unique_ptr<Board>& board = boards[static_cast<std::size_t>(worker)];
+        for (std::size_t i = begin; i < end; i++)
+        {
+            MappedFile file;
+            if (!file.open(paths[i]))
+            {
+                tally.unreadable++;
+                continue;
+            }
+            ReplayReader reader(file.data(), file.size());
+            if (!reader.valid())
+            {
+                tally.unreadable++;
+                continue;
+            }
+            //replays of the same board size in a row reuse the worker's board
+            const ReplayHeader& header = reader.header();
+            if (!board || board->rows() != header.rows || board->columns() != header.columns ||
+                board->mines() != header.mines || board->rules() != header.mode)
+                board = std::make_unique<Board>(header.rows, header.columns, header.mines, header.mode);
+            tally.moves += static_cast<long long>(playReplay(*board, reader));
+            tally.replays++;
+            tally.won += board->state() == 2;
+            tally.lost += board->state() == 1;
+            tally.totalScore += board->score();
+            tally.milliseconds += reader.lastTick();
+        }
+    });
+    ReplayStats total;
+    for (const ReplayStats& tally : stats)
+    {
+        total.replays += tally.replays;
+        total.unreadable += tally.unreadable;
+        total.won += tally.won;
+        total.lost += tally.lost;
+        total.moves += tally.moves;
+        total.totalScore += tally.totalScore;
+        total.milliseconds += tally.milliseconds;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double replays = static_cast<double>(std::max(total.replays, 1LL));
+    std::cout << std::fixed << std::setprecision(4)
+              << "replays " << total.replays << " from " << folder << "\n"
+              << "  unreadable " << total.unreadable << "\n"
+              << "  win rate " << static_cast<double>(total.won) / replays << "\n"
+              << "  loss rate " << static_cast<double>(total.lost) / replays << "\n"
+              << "  unfinished " << total.replays - total.won - total.lost << "\n"
+              << "  average moves " << static_cast<double>(total.moves) / replays << "\n"
+              << "  average score " << static_cast<double>(total.totalScore) / replays << "\n"
+              << "  average game seconds " << static_cast<double>(total.milliseconds) / 1000.0 / replays << "\n"
+              << "  seconds " << seconds << "\n"
+              << "  replays per second " << std::setprecision(0) << (seconds > 0 ? static_cast<double>(total.replays) / seconds : 0.0) << "\n";
+    return 0;
+}
+
+void report(const PresetInfo& preset, const Stats& stats, double seconds)
+{
+    const double games = static_cast<double>(stats.games);
+    std::cout << std::fixed << std::setprecision(4)
+              << "preset " << preset.name << " (" << preset.rows << "x" << preset.columns << ", " << preset.mines << " mines)\n"
+              << "  games " << stats.games << "\n"
+              << "  win rate " << static_cast<double>(stats.won) / games << "\n"
+              << "  loss rate " << static_cast<double>(stats.lost) / games << "\n"
+              << "  unfinished " << stats.games - stats.won - stats.lost << "\n"
+              << "  average clicks " << static_cast<double>(stats.clicks) / games << "\n"
+              << "  average score " << static_cast<double>(stats.totalScore) / games << "\n"
+              << "  score p10/p50/p90/p99 " << stats.percentile(0.1) << " " << stats.percentile(0.5) << " "
+              << stats.percentile(0.9) << " " << stats.percentile(0.99) << "\n";
+    if (preset.mode == GameMode::Demolition)
+    {
+        std::cout << "  survival " << 1.0 - static_cast<double>(stats.lives[0]) / games << "\n"
+                  << "  games by lives left";
+        for (int lives = 0; lives < 6; lives++)
+            std::cout << " " << lives << ":" << stats.lives[lives];
+        std::cout << "\n";
+    }
+    std::cout << "  seconds " << seconds << "\n"
+              << "  games per second " << std::setprecision(0) << (seconds > 0 ? games / seconds : 0.0) << "\n";
+}
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parse(argc, argv, options))
+    {
+        std::cerr << "usage: minesweeper_sim [--preset easy|medium|hard|demolition|large] [--rows N] [--columns N] [--mines N]\n"
+                     "                       [--mode classic|demolition] [--games N] [--seed N] [--script file]\n"
+                     "                       [--threads N] [--batch] [--player random|solver]\n"
+                     "       minesweeper_sim --replays folder [--threads N]\n";
+        return 2;
+    }
+    std::vector<Move> moves;
+    if (!options.script.empty() && !readScript(options.script, moves))
+    {
+        std::cerr << "cannot read " << options.script << "\n";
+        return 1;
+    }
+
+    ThreadPool pool(options.threads);
+    if (!options.replays.empty())
+        return analyseReplays(options.replays, pool);
+    std::vector<PresetInfo> presets;
+    if (options.batch)
+        presets = shippedPresets();
+    else
+        presets.push_back(options.preset);
+    std::cout << "threads " << pool.size() << "\n";
+    for (const PresetInfo& preset : presets)
+    {
+        auto start = std::chrono::steady_clock::now();
+        Stats stats = simulate(options, preset, moves, pool);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report(preset, stats, seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+// packs the game's images, sounds and font into the one archive the game maps at startup
+//
+// pack_assets output file...
+//
+// every file is stored under its name without the folder, so "src/imagesAudio/backButton.png"
+// is found as "backButton.png"; the layout is described at the top of core/Archive.h
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+#include "../core/Archive.h"
+
+namespace
+{
+struct Packed
+{
+    std::string name;
+    std::vector<char> bytes;
+    std::uint64_t offset = 0;
+};
+
+template <class T>
+void writeLittle(std::ofstream& out, T value)
+{
+    for (std::size_t i = 0; i < sizeof(T); i++)
+        out.put(static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xff));
+}
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: pack_assets output file...\n";
+        return 2;
+    }
+    std::vector<Packed> files;
+    std::set<std::string> names;
+    for (int i = 2; i < argc; i++)
+    {
+        Packed packed;
+        packed.name = std::filesystem::path(argv[i]).filename().string();
+        if (packed.name.size() > UINT16_MAX || !names.insert(packed.name).second)
+        {
+            std::cerr << "cannot pack " << argv[i] << ", its name is too long or already packed\n";
+            return 1;
+        }
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in)
+        {
+            std::cerr << "cannot read " << argv[i] << "\n";
+            return 1;
+        }
+        packed.bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        files.push_back(std::move(packed));
+    }
+
+    //offsets follow the index, so its size is worked out first
+    std::uint64_t at = sizeof(ARCHIVE_MAGIC) + 4;
+    for (const Packed& packed : files)
+        at += 2 + packed.name.size() + 16;
+    for (Packed& packed : files)
+    {
+        at = (at + ARCHIVE_ALIGN - 1) / ARCHIVE_ALIGN * ARCHIVE_ALIGN;
+        packed.offset = at;
+        at += packed.bytes.size();
+    }
+
+    //written next to the output and renamed over it, so the game never maps half an archive
+    const std::string temporary = std::string(argv[1]) + ".part";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            std::cerr << "cannot write " << temporary << "\n";
+            return 1;
+        }
+        out.write(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+        writeLittle<std::uint32_t>(out, static_cast<std::uint32_t>(files.size()));
+        for (const Packed& packed : files)
+        {
+            writeLittle<std::uint16_t>(out, static_cast<std::uint16_t>(packed.name.size()));
+            out.write(packed.name.data(), static_cast<std::streamsize>(packed.name.size()));
+            writeLittle<std::uint64_t>(out, packed.offset);
+            writeLittle<std::uint64_t>(out, packed.bytes.size());
+        }
+        for (const Packed& packed : files)
+        {
+            while (static_cast<std::uint64_t>(out.tellp()) < packed.offset)
+                out.put('\0');
+            out.write(packed.bytes.data(), static_cast<std::streamsize>(packed.bytes.size()));
+        }
+        if (!out)
+        {
+            std::cerr << "cannot write " << temporary << "\n";
+            return 1;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, argv[1], error);
+    if (error)
+    {
+        std::cerr << "cannot replace " << argv[1] << ": " << error.message() << "\n";
+        return 1;
+    }
+    std::cout << "packed " << files.size() << " files into " << argv[1] << "\n";
+    return 0;
+}